@@ -0,0 +1,271 @@
+/*
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <QSignalSpy>
+#include <QTest>
+
+#include "LoginQueue.h"
+
+using namespace PLASMALOGIN;
+
+class LoginQueueTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void init();
+    void cleanup();
+
+    void startsWhenIdle();
+    void busyWhileSessionRuns();
+    void queuesOtherGreeters();
+    void failedLoginStaysPending();
+    void newerAttemptCancels();
+    void newerAttemptSupersedesQueued();
+    void busyWhenQueueFull();
+    void successRejectsQueued();
+    void startFailureStartsNext();
+    void skipsGoneGreeters();
+    void clearDropsEverything();
+
+private:
+    LoginQueue::Request request(QObject *client, const QString &user = QStringLiteral("alice"));
+    QString startedUser() const;
+
+    LoginQueue *m_queue = nullptr;
+    QObject *m_a = nullptr;
+    QObject *m_b = nullptr;
+    QList<QString> m_started;
+};
+
+void LoginQueueTest::init()
+{
+    m_queue = new LoginQueue(this);
+    m_a = new QObject(this);
+    m_b = new QObject(this);
+    m_started.clear();
+    connect(m_queue, &LoginQueue::start, this, [this](const LoginQueue::Request &request) {
+        m_started.append(request.user);
+    });
+}
+
+void LoginQueueTest::cleanup()
+{
+    delete m_queue;
+    delete m_a;
+    delete m_b;
+}
+
+LoginQueue::Request LoginQueueTest::request(QObject *client, const QString &user)
+{
+    return {client, user, QStringLiteral("secret"), Session()};
+}
+
+QString LoginQueueTest::startedUser() const
+{
+    return m_started.isEmpty() ? QString() : m_started.last();
+}
+
+void LoginQueueTest::startsWhenIdle()
+{
+    m_queue->login(request(m_a), false);
+
+    QCOMPARE(m_started, QList<QString>{QStringLiteral("alice")});
+    QCOMPARE(m_queue->current(), m_a);
+    QVERIFY(m_queue->isPending());
+    QCOMPARE(m_queue->queued(), 0);
+}
+
+void LoginQueueTest::busyWhileSessionRuns()
+{
+    QSignalSpy busy(m_queue, &LoginQueue::busy);
+
+    // the helper runs a user session, no greeter login is pending
+    m_queue->login(request(m_a), true);
+
+    QCOMPARE(busy.count(), 1);
+    QCOMPARE(busy.at(0).at(0).value<QObject *>(), m_a);
+    QVERIFY(m_started.isEmpty());
+    QCOMPARE(m_queue->queued(), 0);
+}
+
+void LoginQueueTest::queuesOtherGreeters()
+{
+    QSignalSpy stop(m_queue, &LoginQueue::stopHelper);
+
+    m_queue->login(request(m_a), false);
+    m_queue->login(request(m_b, QStringLiteral("bob")), true);
+
+    QCOMPARE(m_queue->queued(), 1);
+    QCOMPARE(stop.count(), 0);
+    QCOMPARE(startedUser(), QStringLiteral("alice"));
+
+    m_queue->authenticated(false);
+    m_queue->helperFinished();
+
+    QCOMPARE(startedUser(), QStringLiteral("bob"));
+    QCOMPARE(m_queue->current(), m_b);
+    QCOMPARE(m_queue->queued(), 0);
+}
+
+void LoginQueueTest::failedLoginStaysPending()
+{
+    QSignalSpy failed(m_queue, &LoginQueue::failed);
+    QSignalSpy busy(m_queue, &LoginQueue::busy);
+    QSignalSpy stop(m_queue, &LoginQueue::stopHelper);
+
+    m_queue->login(request(m_a), false);
+    m_queue->authenticated(false);
+
+    QCOMPARE(failed.count(), 1);
+    QCOMPARE(failed.at(0).at(0).value<QObject *>(), m_a);
+    QVERIFY(m_queue->isPending());
+    QCOMPARE(m_queue->current(), nullptr);
+
+    // the retry arrives before the failed helper has exited
+    m_queue->login(request(m_a, QStringLiteral("alice2")), true);
+
+    QCOMPARE(busy.count(), 0);
+    QCOMPARE(stop.count(), 0);
+    QCOMPARE(m_queue->queued(), 1);
+
+    m_queue->helperFinished();
+
+    QCOMPARE(startedUser(), QStringLiteral("alice2"));
+    QCOMPARE(m_queue->current(), m_a);
+    QCOMPARE(failed.count(), 1);
+}
+
+void LoginQueueTest::newerAttemptCancels()
+{
+    QSignalSpy failed(m_queue, &LoginQueue::failed);
+    QSignalSpy cancelled(m_queue, &LoginQueue::cancelled);
+    QSignalSpy stop(m_queue, &LoginQueue::stopHelper);
+
+    m_queue->login(request(m_a), false);
+    m_queue->login(request(m_a, QStringLiteral("alice2")), true);
+
+    QCOMPARE(stop.count(), 1);
+    QVERIFY(m_queue->isCancelling());
+
+    // the stopped helper's answer is not passed on
+    m_queue->authenticated(false);
+    QCOMPARE(failed.count(), 0);
+
+    m_queue->helperFinished();
+
+    QCOMPARE(cancelled.count(), 1);
+    QCOMPARE(cancelled.at(0).at(0).value<QObject *>(), m_a);
+    QVERIFY(!m_queue->isCancelling());
+    QCOMPARE(startedUser(), QStringLiteral("alice2"));
+}
+
+void LoginQueueTest::newerAttemptSupersedesQueued()
+{
+    QSignalSpy cancelled(m_queue, &LoginQueue::cancelled);
+
+    m_queue->login(request(m_b, QStringLiteral("bob")), false);
+    m_queue->login(request(m_a), true);
+    m_queue->login(request(m_a, QStringLiteral("alice2")), true);
+
+    QCOMPARE(cancelled.count(), 1);
+    QCOMPARE(cancelled.at(0).at(0).value<QObject *>(), m_a);
+    QCOMPARE(m_queue->queued(), 1);
+
+    m_queue->authenticated(false);
+    m_queue->helperFinished();
+
+    QCOMPARE(startedUser(), QStringLiteral("alice2"));
+}
+
+void LoginQueueTest::busyWhenQueueFull()
+{
+    QSignalSpy busy(m_queue, &LoginQueue::busy);
+    QList<QObject *> clients;
+
+    m_queue->login(request(m_a), false);
+    for (int i = 0; i < LoginQueue::maxQueued; ++i) {
+        clients.append(new QObject(this));
+        m_queue->login(request(clients.last()), true);
+    }
+    QCOMPARE(m_queue->queued(), LoginQueue::maxQueued);
+    QCOMPARE(busy.count(), 0);
+
+    m_queue->login(request(m_b), true);
+
+    QCOMPARE(busy.count(), 1);
+    QCOMPARE(busy.at(0).at(0).value<QObject *>(), m_b);
+    QCOMPARE(m_queue->queued(), LoginQueue::maxQueued);
+    qDeleteAll(clients);
+}
+
+void LoginQueueTest::successRejectsQueued()
+{
+    QSignalSpy succeeded(m_queue, &LoginQueue::succeeded);
+    QSignalSpy busy(m_queue, &LoginQueue::busy);
+
+    m_queue->login(request(m_a), false);
+    m_queue->login(request(m_b), true);
+    m_queue->authenticated(true);
+
+    QCOMPARE(succeeded.count(), 1);
+    QCOMPARE(succeeded.at(0).at(0).value<QObject *>(), m_a);
+    QCOMPARE(busy.count(), 1);
+    QCOMPARE(busy.at(0).at(0).value<QObject *>(), m_b);
+    QVERIFY(!m_queue->isPending());
+    QCOMPARE(m_queue->queued(), 0);
+
+    // the user session owns the helper now
+    m_queue->login(request(m_b), true);
+    QCOMPARE(busy.count(), 2);
+}
+
+void LoginQueueTest::startFailureStartsNext()
+{
+    QSignalSpy failed(m_queue, &LoginQueue::failed);
+
+    m_queue->login(request(m_a), false);
+    m_queue->login(request(m_b, QStringLiteral("bob")), true);
+    m_queue->startFailed();
+
+    QCOMPARE(failed.count(), 1);
+    QCOMPARE(failed.at(0).at(0).value<QObject *>(), m_a);
+    QCOMPARE(startedUser(), QStringLiteral("bob"));
+    QCOMPARE(m_queue->current(), m_b);
+}
+
+void LoginQueueTest::skipsGoneGreeters()
+{
+    QObject *gone = new QObject(this);
+
+    m_queue->login(request(m_a), false);
+    m_queue->login(request(gone, QStringLiteral("gone")), true);
+    m_queue->login(request(m_b, QStringLiteral("bob")), true);
+    delete gone;
+
+    m_queue->authenticated(false);
+    m_queue->helperFinished();
+
+    QCOMPARE(m_started, (QList<QString>{QStringLiteral("alice"), QStringLiteral("bob")}));
+}
+
+void LoginQueueTest::clearDropsEverything()
+{
+    QSignalSpy busy(m_queue, &LoginQueue::busy);
+    QSignalSpy cancelled(m_queue, &LoginQueue::cancelled);
+
+    m_queue->login(request(m_a), false);
+    m_queue->login(request(m_b), true);
+    m_queue->clear();
+
+    QVERIFY(!m_queue->isPending());
+    QCOMPARE(m_queue->current(), nullptr);
+    QCOMPARE(m_queue->queued(), 0);
+    QCOMPARE(busy.count(), 0);
+    QCOMPARE(cancelled.count(), 0);
+}
+
+QTEST_GUILESS_MAIN(LoginQueueTest)
+
+#include "loginqueuetest.moc"
@@ -11,15 +11,21 @@
 #include "Constants.h"
 #include "SafeDataStream.h"
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QMutex>
+#include <QtCore/QPointer>
 #include <QtCore/QProcess>
+#include <QtCore/QTimer>
 #include <QtCore/QUuid>
 #include <QtNetwork/QLocalServer>
 #include <QtNetwork/QLocalSocket>
 
 #include <QtQml/QtQml>
 
-#include <memory>
+#include <atomic>
 
+#include <sys/stat.h>
 #include <unistd.h>
 
 namespace PLASMALOGIN
@@ -31,19 +37,16 @@ public slots:
     void handleNewConnection();
 
 public:
-    static SocketServer *instance();
+    explicit SocketServer(QObject *parent);
 
     QMap<qint64, Auth::Private *> helpers;
-
-private:
-    SocketServer();
 };
 
 class Auth::Private : public QObject
 {
     Q_OBJECT
 public:
-    Private(Auth *parent);
+    Private(SocketServer *server, Auth *parent);
     ~Private();
     void setSocket(QLocalSocket *socket);
 public slots:
@@ -55,22 +58,28 @@ public slots:
 public:
     AuthRequest *request{nullptr};
     QProcess *child{nullptr};
+    QTimer *killTimer{nullptr};
+    QPointer<SocketServer> server;
+    QElapsedTimer phaseTimer;
     QLocalSocket *socket{nullptr};
     QString sessionPath{};
     QString user{};
+    QString sessionId{};
     bool autologin{false};
     bool greeter{false};
-    QProcessEnvironment environment{};
+    bool background{false};
+    Environment environment{};
     qint64 id{0};
-    static qint64 lastId;
+    static std::atomic<qint64> lastId;
 };
 
-qint64 Auth::Private::lastId = 1;
+std::atomic<qint64> Auth::Private::lastId = 1;
 
-Auth::SocketServer::SocketServer()
-    : QLocalServer()
+Auth::SocketServer::SocketServer(QObject *parent)
+    : QLocalServer(parent)
 {
     connect(this, &QLocalServer::newConnection, this, &Auth::SocketServer::handleNewConnection);
+    listen(QStringLiteral("plasmalogin-auth-%1").arg(QUuid::createUuid().toString(QUuid::WithoutBraces)));
 }
 
 void Auth::SocketServer::handleNewConnection()
@@ -82,7 +91,7 @@ void Auth::SocketServer::handleNewConnection()
         SafeDataStream str(socket);
         str.receive();
         str >> m >> id;
-        if (m == Msg::HELLO && id && SocketServer::instance()->helpers.contains(id)) {
+        if (m == Msg::HELLO && id && helpers.contains(id)) {
             helpers[id]->setSocket(socket);
             if (socket->bytesAvailable() > 0) {
                 helpers[id]->dataPending();
@@ -91,43 +100,65 @@ void Auth::SocketServer::handleNewConnection()
     }
 }
 
-Auth::SocketServer *Auth::SocketServer::instance()
+Auth::SocketServer *Auth::createSocketServer(QObject *parent)
 {
-    static std::unique_ptr<Auth::SocketServer> self;
-    if (!self) {
-        self.reset(new SocketServer());
-        self->listen(QStringLiteral("plasmalogin-auth-%1").arg(QUuid::createUuid().toString(QUuid::WithoutBraces)));
-    }
-    return self.get();
+    return new SocketServer(parent);
 }
 
-Auth::Private::Private(Auth *parent)
-    : QObject(parent)
-    , request(new AuthRequest(parent))
-    , child(new QProcess(this))
-    , id(lastId++)
+// The helper runs with the locale from /etc/locale.conf. That file is only
+// changed when the system is reconfigured, so it is parsed once and reused
+// by every helper until its modification time changes.
+static QProcessEnvironment helperEnvironment()
 {
-    SocketServer::instance()->helpers[id] = this;
-    QProcessEnvironment env = child->processEnvironment();
-    bool langEmpty = true;
+    static QMutex mutex;
+    static QProcessEnvironment cached;
+    static struct timespec cachedMtime = {-1, -1};
+    QMutexLocker locker(&mutex);
+
+    struct stat st;
+    struct timespec mtime = {0, 0};
+    if (::stat("/etc/locale.conf", &st) == 0) {
+        mtime = st.st_mtim;
+    }
+    if (mtime.tv_sec == cachedMtime.tv_sec && mtime.tv_nsec == cachedMtime.tv_nsec) {
+        return cached;
+    }
+
+    QProcessEnvironment env;
     QFile localeFile(QStringLiteral("/etc/locale.conf"));
     if (localeFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QTextStream in(&localeFile);
-        while (!in.atEnd()) {
-            QStringList parts = in.readLine().split(QLatin1Char('='));
-            if (parts.size() >= 2) {
-                env.insert(parts[0], parts[1]);
-                if (parts[0] == QLatin1String("LANG")) {
-                    langEmpty = false;
-                }
+        const QByteArray contents = localeFile.readAll();
+        for (const QByteArray &line : contents.split('\n')) {
+            const qsizetype pos = line.indexOf('=');
+            if (pos > 0) {
+                env.insert(QString::fromUtf8(line.first(pos)), QString::fromUtf8(line.sliced(pos + 1)));
             }
         }
-        localeFile.close();
     }
-    if (langEmpty) {
+    if (!env.contains(QStringLiteral("LANG"))) {
         env.insert(QStringLiteral("LANG"), QStringLiteral("C"));
     }
-    child->setProcessEnvironment(env);
+
+    cached = env;
+    cachedMtime = mtime;
+    return cached;
+}
+
+Auth::Private::Private(SocketServer *server, Auth *parent)
+    : QObject(parent)
+    , request(new AuthRequest(parent))
+    , child(new QProcess(this))
+    , killTimer(new QTimer(this))
+    , server(server)
+    , id(lastId++)
+{
+    Q_ASSERT(server);
+    server->helpers[id] = this;
+    child->setProcessEnvironment(helperEnvironment());
+    // escalate to SIGKILL if the helper ignores SIGTERM, see Auth::stop()
+    killTimer->setSingleShot(true);
+    killTimer->setInterval(5000);
+    connect(killTimer, &QTimer::timeout, child, &QProcess::kill);
     connect(child, &QProcess::finished, this, &Auth::Private::childExited);
     connect(child, &QProcess::errorOccurred, this, &Auth::Private::childError);
     connect(request, &AuthRequest::finished, this, &Auth::Private::requestFinished);
@@ -136,13 +167,18 @@ Auth::Private::Private(Auth *parent)
 
 Auth::Private::~Private()
 {
-    SocketServer::instance()->helpers.remove(id);
+    // the server goes away with its seat, possibly before us
+    if (server) {
+        server->helpers.remove(id);
+    }
 }
 
 void Auth::Private::setSocket(QLocalSocket *socket)
 {
     this->socket = socket;
     connect(socket, &QLocalSocket::readyRead, this, &Auth::Private::dataPending);
+
+    Q_EMIT qobject_cast<Auth *>(parent())->phaseFinished(QStringLiteral("spawn"), phaseTimer.restart());
 }
 
 void Auth::Private::dataPending()
@@ -177,6 +213,7 @@ void Auth::Private::dataPending()
         case AUTHENTICATED: {
             QString user;
             str >> user;
+            Q_EMIT auth->phaseFinished(QStringLiteral("authenticate"), phaseTimer.restart());
             if (!user.isEmpty()) {
                 auth->setUser(user);
                 Q_EMIT auth->authentication(user, true);
@@ -190,7 +227,8 @@ void Auth::Private::dataPending()
         }
         case SESSION_STATUS: {
             bool status;
-            str >> status;
+            str >> status >> sessionId;
+            Q_EMIT auth->phaseFinished(QStringLiteral("session"), phaseTimer.restart());
             Q_EMIT auth->sessionStarted(status);
             str.reset();
             str << SESSION_STATUS;
@@ -215,6 +253,8 @@ void Auth::Private::dataPending()
 
 void Auth::Private::childExited(int exitCode, QProcess::ExitStatus exitStatus)
 {
+    killTimer->stop();
+
     if (exitStatus != QProcess::NormalExit) {
         qWarning("Auth: plasmalogin-helper (%s) crashed (signal %d)", qPrintable(child->arguments().join(QLatin1Char(' '))), exitCode);
         Q_EMIT qobject_cast<Auth *>(parent())->error(child->errorString(), ERROR_INTERNAL);
@@ -248,9 +288,9 @@ void Auth::Private::requestFinished()
     request->setRequest();
 }
 
-Auth::Auth(const QString &user, const QString &session, bool autologin, QObject *parent, bool verbose)
+Auth::Auth(SocketServer *server, const QString &user, const QString &session, bool autologin, QObject *parent, bool verbose)
     : QObject(parent)
-    , d(new Private(this))
+    , d(new Private(server, this))
 {
     setUser(user);
     setAutologin(autologin);
@@ -258,15 +298,23 @@ Auth::Auth(const QString &user, const QString &session, bool autologin, QObject
     setVerbose(verbose);
 }
 
-Auth::Auth(QObject *parent)
+Auth::Auth(SocketServer *server, QObject *parent)
     : QObject(parent)
-    , d(new Private(this))
+    , d(new Private(server, this))
 {
 }
 
 Auth::~Auth()
 {
-    stop();
+    // Owners are expected to call stop() and wait for finished(), this is only
+    // the last resort so that we never leave a helper behind.
+    if (d->child->state() != QProcess::NotRunning) {
+        d->child->terminate();
+        if (!d->child->waitForFinished(5000)) {
+            d->child->kill();
+            d->child->waitForFinished(1000);
+        }
+    }
     delete d;
 }
 
@@ -274,7 +322,7 @@ void Auth::registerTypes()
 {
     qmlRegisterAnonymousType<AuthPrompt>("Auth", 1);
     qmlRegisterAnonymousType<AuthRequest>("Auth", 1);
-    qmlRegisterType<Auth>("Auth", 1, 0, "Auth");
+    qmlRegisterUncreatableType<Auth>("Auth", 1, 0, "Auth", QStringLiteral("Auth needs a socket server"));
 }
 
 bool Auth::autologin() const
@@ -287,11 +335,21 @@ bool Auth::isGreeter() const
     return d->greeter;
 }
 
+bool Auth::background() const
+{
+    return d->background;
+}
+
 const QString &Auth::session() const
 {
     return d->sessionPath;
 }
 
+const QString &Auth::sessionId() const
+{
+    return d->sessionId;
+}
+
 const QString &Auth::user() const
 {
     return d->user;
@@ -312,7 +370,7 @@ bool Auth::isActive() const
     return d->child->state() != QProcess::NotRunning;
 }
 
-void Auth::insertEnvironment(const QProcessEnvironment &env)
+void Auth::insertEnvironment(const Environment &env)
 {
     d->environment.insert(env);
 }
@@ -346,6 +404,14 @@ void Auth::setGreeter(bool on)
     }
 }
 
+void Auth::setBackground(bool on)
+{
+    if (on != d->background) {
+        d->background = on;
+        Q_EMIT backgroundChanged();
+    }
+}
+
 void Auth::setSession(const QString &path)
 {
     if (path != d->sessionPath) {
@@ -368,8 +434,10 @@ void Auth::setVerbose(bool on)
 
 void Auth::start()
 {
+    d->sessionId.clear();
+
     QStringList args;
-    args << QStringLiteral("--socket") << SocketServer::instance()->fullServerName();
+    args << QStringLiteral("--socket") << d->server->fullServerName();
     args << QStringLiteral("--id") << QString::number(d->id);
     if (!d->sessionPath.isEmpty()) {
         args << QStringLiteral("--start") << d->sessionPath;
@@ -383,6 +451,10 @@ void Auth::start()
     if (d->greeter) {
         args << QStringLiteral("--greeter");
     }
+    if (d->background) {
+        args << QStringLiteral("--background");
+    }
+    d->phaseTimer.start();
     d->child->start(QStringLiteral("%1/plasmalogin-helper").arg(QStringLiteral(LIBEXEC_INSTALL_DIR)), args);
 }
 
@@ -394,9 +466,9 @@ void Auth::stop()
 
     d->child->terminate();
 
-    // wait for finished
-    if (!d->child->waitForFinished(5000)) {
-        d->child->kill();
+    // don't block, finished() is emitted once the helper has been reaped
+    if (!d->killTimer->isActive()) {
+        d->killTimer->start();
     }
 }
 }
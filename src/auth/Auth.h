@@ -11,9 +11,9 @@
 
 #include "AuthPrompt.h"
 #include "AuthRequest.h"
+#include "Environment.h"
 
 #include <QtCore/QObject>
-#include <QtCore/QProcessEnvironment>
 
 namespace PLASMALOGIN
 {
@@ -34,15 +34,28 @@ namespace PLASMALOGIN
  *
  * Usage:
  *
- * Just construct, connect the signals (especially \ref requestChanged)
- * and fire up \ref start
+ * Create a \ref SocketServer, construct with it, connect the signals
+ * (especially \ref requestChanged) and fire up \ref start
  */
 class Auth : public QObject
 {
     Q_OBJECT
 public:
-    explicit Auth(const QString &user = QString(), const QString &session = QString(), bool autologin = false, QObject *parent = 0, bool verbose = false);
-    explicit Auth(QObject *parent);
+    class SocketServer;
+
+    /**
+     * Creates the local server the helpers connect back to. It has to live on the
+     * thread of the Auth objects using it, and may be destroyed before them.
+     */
+    static SocketServer *createSocketServer(QObject *parent);
+
+    explicit Auth(SocketServer *server,
+                  const QString &user,
+                  const QString &session = QString(),
+                  bool autologin = false,
+                  QObject *parent = 0,
+                  bool verbose = false);
+    explicit Auth(SocketServer *server, QObject *parent);
     ~Auth();
 
     enum Info {
@@ -75,9 +88,14 @@ public:
 
     bool autologin() const;
     bool isGreeter() const;
+    bool background() const;
     bool verbose() const;
     const QString &user() const;
     const QString &session() const;
+    /**
+     * The logind id of the started session, empty until it started or if unknown
+     */
+    const QString &sessionId() const;
     AuthRequest *request();
     /**
      * True if an authentication or session is in progress
@@ -90,7 +108,7 @@ public:
      * User-specific data such as $HOME is generated automatically.
      * @param env the environment
      */
-    void insertEnvironment(const QProcessEnvironment &env);
+    void insertEnvironment(const Environment &env);
 
     /**
      * Works the same as \ref insertEnvironment but only for one key-value pair
@@ -112,6 +130,12 @@ public:
      */
     void setGreeter(bool on = true);
 
+    /**
+     * Start the session without switching to its VT
+     * @param on true if the session should stay in the background
+     */
+    void setBackground(bool on = true);
+
     /**
      * Forwards the output of the underlying authenticator to the current process
      * @param on true if should forward the output
@@ -138,12 +162,17 @@ public Q_SLOTS:
 
     /**
      * Indicates that we do not need the process anymore.
+     *
+     * The helper is asked to terminate and is killed if it is still running
+     * after 5 seconds. This does not block, \ref finished is emitted once the
+     * helper has exited.
      */
     void stop();
 
 Q_SIGNALS:
     void autologinChanged();
     void greeterChanged();
+    void backgroundChanged();
     void verboseChanged();
     void userChanged();
     void displayServerCommandChanged();
@@ -175,6 +204,15 @@ Q_SIGNALS:
      */
     void displayServerReady(const QString &displayName);
 
+    /**
+     * Emitted when a phase of the helper's work is done, for diagnostics
+     *
+     * @param phase "spawn" until the helper connected, "authenticate" for the PAM
+     * conversation, "session" for opening the PAM session and starting the session
+     * @param msecs duration of the phase
+     */
+    void phaseFinished(const QString &phase, qint64 msecs);
+
     /**
      * Emitted when the helper quits, either after authentication or when the session ends.
      * Or, when something goes wrong.
@@ -199,7 +237,6 @@ Q_SIGNALS:
 
 private:
     class Private;
-    class SocketServer;
     friend Private;
     friend SocketServer;
     Private *d{nullptr};
@@ -10,9 +10,9 @@
 #define MESSAGES_H
 
 #include <QtCore/QDataStream>
-#include <QtCore/QProcessEnvironment>
 
 #include "Auth.h"
+#include "Environment.h"
 
 namespace PLASMALOGIN
 {
@@ -175,23 +175,6 @@ inline QDataStream &operator>>(QDataStream &s, Auth::Info &m)
     return s;
 }
 
-inline QDataStream &operator<<(QDataStream &s, const QProcessEnvironment &m)
-{
-    s << m.toStringList();
-    return s;
-}
-
-inline QDataStream &operator>>(QDataStream &s, QProcessEnvironment &m)
-{
-    QStringList l;
-    s >> l;
-    for (QString s : l) {
-        int pos = s.indexOf(QLatin1Char('='));
-        m.insert(s.left(pos), s.mid(pos + 1));
-    }
-    return s;
-}
-
 inline QDataStream &operator<<(QDataStream &s, const Prompt &m)
 {
     s << qint32(m.type) << m.message << m.hidden << m.response;
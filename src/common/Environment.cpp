@@ -0,0 +1,95 @@
+/***************************************************************************
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ ***************************************************************************/
+
+#include "Environment.h"
+
+namespace PLASMALOGIN
+{
+bool Environment::isEmpty() const
+{
+    return m_variables.isEmpty();
+}
+
+bool Environment::contains(const QString &key) const
+{
+    return m_variables.contains(key);
+}
+
+QString Environment::value(const QString &key, const QString &defaultValue) const
+{
+    return m_variables.value(key, defaultValue);
+}
+
+void Environment::insert(const QString &key, const QString &value)
+{
+    m_variables.insert(key, value);
+}
+
+void Environment::insert(const Environment &other)
+{
+    if (m_variables.isEmpty()) {
+        // just share the other side's data
+        m_variables = other.m_variables;
+        return;
+    }
+    m_variables.insert(other.m_variables);
+}
+
+void Environment::remove(const QString &key)
+{
+    m_variables.remove(key);
+}
+
+void Environment::insertFromSystem(const QStringList &names)
+{
+    for (const QString &name : names) {
+        if (qEnvironmentVariableIsSet(qPrintable(name))) {
+            m_variables.insert(name, qEnvironmentVariable(qPrintable(name)));
+        }
+    }
+}
+
+QStringList Environment::toStringList() const
+{
+    QStringList list;
+    list.reserve(m_variables.size());
+    for (auto it = m_variables.constBegin(); it != m_variables.constEnd(); ++it) {
+        list.append(it.key() + QLatin1Char('=') + it.value());
+    }
+    return list;
+}
+
+QProcessEnvironment Environment::toProcessEnvironment() const
+{
+    QProcessEnvironment env;
+    for (auto it = m_variables.constBegin(); it != m_variables.constEnd(); ++it) {
+        env.insert(it.key(), it.value());
+    }
+    return env;
+}
+
+Environment Environment::fromStringList(const QStringList &list)
+{
+    Environment env;
+    for (const QString &entry : list) {
+        const qsizetype pos = entry.indexOf(QLatin1Char('='));
+        if (pos > 0) {
+            env.m_variables.insert(entry.left(pos), entry.mid(pos + 1));
+        }
+    }
+    return env;
+}
+}
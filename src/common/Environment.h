@@ -0,0 +1,83 @@
+/***************************************************************************
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ ***************************************************************************/
+
+#ifndef PLASMALOGIN_ENVIRONMENT_H
+#define PLASMALOGIN_ENVIRONMENT_H
+
+#include <QDataStream>
+#include <QMap>
+#include <QProcessEnvironment>
+#include <QString>
+#include <QStringList>
+
+namespace PLASMALOGIN
+{
+/**
+ * Copy-on-write set of environment variables used to build the
+ * environment of greeter and user sessions.
+ *
+ * Copies share their data until one of them is modified, so the
+ * environment can be passed from the daemon through the auth helper to
+ * the session without being rebuilt at every step. It is only turned
+ * into a QProcessEnvironment right before the session is started.
+ */
+class Environment
+{
+public:
+    Environment() = default;
+
+    bool isEmpty() const;
+    bool contains(const QString &key) const;
+    QString value(const QString &key, const QString &defaultValue = QString()) const;
+
+    void insert(const QString &key, const QString &value);
+    void insert(const Environment &other);
+    void remove(const QString &key);
+
+    /**
+     * Copy the variables in @p names from the daemon's own environment,
+     * skipping the ones that are not set.
+     */
+    void insertFromSystem(const QStringList &names);
+
+    QStringList toStringList() const;
+    QProcessEnvironment toProcessEnvironment() const;
+
+    /**
+     * Parse a list of KEY=VALUE entries, entries without '=' are ignored.
+     */
+    static Environment fromStringList(const QStringList &list);
+
+private:
+    QMap<QString, QString> m_variables;
+};
+
+inline QDataStream &operator<<(QDataStream &s, const Environment &m)
+{
+    s << m.toStringList();
+    return s;
+}
+
+inline QDataStream &operator>>(QDataStream &s, Environment &m)
+{
+    QStringList l;
+    s >> l;
+    m = Environment::fromStringList(l);
+    return s;
+}
+}
+
+#endif // PLASMALOGIN_ENVIRONMENT_H
@@ -0,0 +1,362 @@
+/***************************************************************************
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ ***************************************************************************/
+
+#include "LogWriter.h"
+
+#include "Constants.h"
+
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <systemd/sd-journal.h>
+
+namespace PLASMALOGIN
+{
+// per category, debug and info messages beyond this are dropped until the window ends
+static constexpr qint64 s_rateLimitInterval = 5000;
+static constexpr int s_rateLimitBurst = 200;
+
+static qint64 currentMSecsSinceEpoch()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return qint64(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int journalPriority(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg:
+        return LOG_DEBUG;
+    case QtInfoMsg:
+        return LOG_INFO;
+    case QtWarningMsg:
+        return LOG_WARNING;
+    case QtCriticalMsg:
+        return LOG_CRIT;
+    case QtFatalMsg:
+        return LOG_ALERT;
+    }
+    return LOG_INFO;
+}
+
+static int openLogFile()
+{
+    // Only log to a file if we're not outputting to a terminal
+    if (isatty(STDERR_FILENO)) {
+        return -1;
+    }
+
+    int fd = ::open(LOG_FILE, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+
+    // If we can't open the file, create it in a writable location
+    // It will look something like ~/.local/share/$appname/plasmalogin.log
+    // or for the plasmalogin user /var/lib/plasmalogin/.local/share/$appname/plasmalogin.log
+    if (fd < 0) {
+        const QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+        QDir().mkpath(dataDir);
+        fd = ::open(QFile::encodeName(dataDir + QLatin1String("/plasmalogin.log")).constData(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    }
+
+    return fd;
+}
+
+LogWriter *LogWriter::instance()
+{
+    // Never destroyed, so that messages logged by other destructors still
+    // work. The queue is drained at exit.
+    static LogWriter *self = [] {
+        auto writer = new LogWriter;
+        std::atexit([] {
+            instance()->shutdown();
+        });
+        return writer;
+    }();
+    return self;
+}
+
+LogWriter::LogWriter()
+    // don't log to journald if running interactively, this is likely
+    // the case when running plasmalogin in test mode
+    : m_interactive(isatty(STDERR_FILENO) && qgetenv("USER") != "plasmalogin")
+    , m_pid(getpid())
+{
+    for (size_t i = 0; i < s_capacity; ++i) {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    if (m_interactive) {
+        m_logFd = openLogFile();
+    }
+
+    m_thread = std::thread(&LogWriter::run, this);
+}
+
+void LogWriter::shutdown()
+{
+    // exit() in a forked child must not try to join a thread that only exists in the parent
+    if (getpid() != m_pid || !m_thread.joinable()) {
+        return;
+    }
+
+    // a fatal message may drain the queue while the process is exiting
+    std::call_once(m_shutdownOnce, [this] {
+        m_quit.store(true);
+        m_wakeups.fetch_add(1, std::memory_order_release);
+        m_wakeups.notify_one();
+        m_thread.join();
+    });
+}
+
+void LogWriter::log(QtMsgType type, const QMessageLogContext &context, const QString &prefix, const QString &msg)
+{
+    Entry entry;
+    entry.type = type;
+    entry.timestamp = currentMSecsSinceEpoch();
+    entry.line = context.line;
+    qstrncpy(entry.file.data(), context.file ? context.file : "", entry.file.size());
+    qstrncpy(entry.function.data(), context.function ? context.function : "", entry.function.size());
+    qstrncpy(entry.category.data(), context.category ? context.category : "default", entry.category.size());
+    // journald has its own identifier, the prefix is only useful on a terminal
+    entry.message = m_interactive ? (prefix + msg).toUtf8() : msg.toUtf8();
+
+    // A fatal message aborts right after, write what is queued and then it
+    if (type == QtFatalMsg) {
+        shutdown();
+    }
+
+    // The writer thread doesn't exist in a forked child (e.g. a QProcess child
+    // modifier) or after shutdown
+    if (getpid() != m_pid || type == QtFatalMsg || m_quit.load(std::memory_order_relaxed)) {
+        TimestampCache cache;
+        write(entry, cache);
+        return;
+    }
+
+    if (push(std::move(entry))) {
+        // Pairs with the fence in run(): either the writer sees the new entry
+        // before going to sleep, or we see that it sleeps and wake it up.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleeping.load(std::memory_order_relaxed)) {
+            m_wakeups.fetch_add(1, std::memory_order_release);
+            m_wakeups.notify_one();
+        }
+        return;
+    }
+
+    // The queue is full, don't lose anything important.
+    if (type == QtDebugMsg || type == QtInfoMsg) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        TimestampCache cache;
+        write(entry, cache);
+    }
+}
+
+bool LogWriter::push(Entry &&entry)
+{
+    // bounded multi-producer queue, see Dmitry Vyukov's bounded MPMC queue
+    Cell *cell;
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        cell = &m_cells[pos & (s_capacity - 1)];
+        const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->entry = std::move(entry);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool LogWriter::pop(Entry &entry)
+{
+    Cell *cell = &m_cells[m_dequeuePos & (s_capacity - 1)];
+    const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    if (intptr_t(sequence) - intptr_t(m_dequeuePos + 1) < 0) {
+        return false;
+    }
+
+    entry = std::move(cell->entry);
+    cell->sequence.store(m_dequeuePos + s_capacity, std::memory_order_release);
+    ++m_dequeuePos;
+    return true;
+}
+
+void LogWriter::run()
+{
+    Entry entry;
+    for (;;) {
+        while (pop(entry)) {
+            if (!rateLimited(entry)) {
+                write(entry, m_timestampCache);
+            }
+        }
+
+        if (const quint64 dropped = m_dropped.exchange(0, std::memory_order_relaxed)) {
+            Entry note;
+            note.type = QtWarningMsg;
+            note.timestamp = currentMSecsSinceEpoch();
+            qstrncpy(note.category.data(), "default", note.category.size());
+            note.message = QByteArrayLiteral("Log queue overflow, dropped ") + QByteArray::number(dropped) + QByteArrayLiteral(" messages");
+            write(note, m_timestampCache);
+        }
+
+        if (m_quit.load()) {
+            // one last pass for anything queued while we were writing
+            while (pop(entry)) {
+                write(entry, m_timestampCache);
+            }
+            return;
+        }
+
+        const quint32 wakeups = m_wakeups.load(std::memory_order_acquire);
+        m_sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const Cell &next = m_cells[m_dequeuePos & (s_capacity - 1)];
+        if (next.sequence.load(std::memory_order_acquire) == m_dequeuePos + 1 || m_quit.load()) {
+            m_sleeping.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        m_wakeups.wait(wakeups, std::memory_order_acquire);
+        m_sleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+bool LogWriter::rateLimited(const Entry &entry)
+{
+    if (entry.type != QtDebugMsg && entry.type != QtInfoMsg) {
+        return false;
+    }
+
+    RateLimit &limit = m_rateLimits[QByteArray(entry.category.data())];
+    if (entry.timestamp - limit.windowStart >= s_rateLimitInterval) {
+        if (limit.suppressed > 0) {
+            Entry note;
+            note.type = QtWarningMsg;
+            note.timestamp = entry.timestamp;
+            note.category = entry.category;
+            note.message = QByteArrayLiteral("Suppressed ") + QByteArray::number(limit.suppressed) + QByteArrayLiteral(" messages of category ")
+                + QByteArray(entry.category.data());
+            write(note, m_timestampCache);
+        }
+        limit = RateLimit{entry.timestamp, 0, 0};
+    }
+
+    if (++limit.count > s_rateLimitBurst) {
+        ++limit.suppressed;
+        return true;
+    }
+    return false;
+}
+
+void LogWriter::write(const Entry &entry, TimestampCache &cache)
+{
+    if (m_interactive) {
+        writeStandard(entry, cache);
+    } else {
+        writeJournal(entry);
+    }
+}
+
+void LogWriter::writeJournal(const Entry &entry)
+{
+    char priority[16];
+    char file[PATH_MAX + sizeof("CODE_FILE=")];
+    char line[32];
+    char function[sizeof(entry.function) + sizeof("CODE_FUNC=")];
+    char category[sizeof(entry.category) + sizeof("QT_CATEGORY=")];
+
+    const QByteArray message = QByteArrayLiteral("MESSAGE=") + entry.message;
+
+    struct iovec iov[6];
+    int n = 0;
+    auto add = [&iov, &n](const char *data, int length) {
+        iov[n].iov_base = const_cast<char *>(data);
+        iov[n].iov_len = size_t(length);
+        ++n;
+    };
+
+    add(message.constData(), message.size());
+    add(priority, snprintf(priority, sizeof(priority), "PRIORITY=%d", journalPriority(entry.type)));
+    add(file, qMin<int>(snprintf(file, sizeof(file), "CODE_FILE=%s", entry.file[0] ? entry.file.data() : "unknown"), sizeof(file) - 1));
+    add(line, snprintf(line, sizeof(line), "CODE_LINE=%d", entry.line));
+    add(function, qMin<int>(snprintf(function, sizeof(function), "CODE_FUNC=%s", entry.function[0] ? entry.function.data() : "unknown"), sizeof(function) - 1));
+    add(category, snprintf(category, sizeof(category), "QT_CATEGORY=%s", entry.category.data()));
+
+    sd_journal_sendv(iov, n);
+}
+
+void LogWriter::writeStandard(const Entry &entry, TimestampCache &cache)
+{
+    const qint64 second = entry.timestamp / 1000;
+    if (second != cache.second) {
+        const time_t t = time_t(second);
+        struct tm local;
+        localtime_r(&t, &local);
+        strftime(cache.prefix, sizeof(cache.prefix), "[%H:%M:%S", &local);
+        cache.second = second;
+    }
+
+    // set log priority
+    const char *logPriority = "(II)";
+    switch (entry.type) {
+    case QtWarningMsg:
+        logPriority = "(WW)";
+        break;
+    case QtCriticalMsg:
+    case QtFatalMsg:
+        logPriority = "(EE)";
+        break;
+    default:
+        break;
+    }
+
+    char header[48];
+    const int headerLength = snprintf(header, sizeof(header), "%s.%03d] %s ", cache.prefix, int(entry.timestamp % 1000), logPriority);
+
+    struct iovec iov[3];
+    iov[0].iov_base = header;
+    iov[0].iov_len = size_t(qMin<int>(headerLength, sizeof(header) - 1));
+    iov[1].iov_base = const_cast<char *>(entry.message.constData());
+    iov[1].iov_len = size_t(entry.message.size());
+    iov[2].iov_base = const_cast<char *>("\n");
+    iov[2].iov_len = 1;
+
+    // a single writev keeps lines from concurrent writers intact
+    if (writev(m_logFd >= 0 ? m_logFd : STDERR_FILENO, iov, 3) < 0) {
+        // nowhere left to report this
+    }
+}
+}
@@ -0,0 +1,116 @@
+/***************************************************************************
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ ***************************************************************************/
+
+#ifndef PLASMALOGIN_LOGWRITER_H
+#define PLASMALOGIN_LOGWRITER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QtGlobal>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include <sys/types.h>
+
+namespace PLASMALOGIN
+{
+/**
+ * Asynchronous backend for the Qt message handlers.
+ *
+ * Messages are put into a bounded lock-free queue and written by a
+ * dedicated thread, either to journald with sd_journal_sendv() or, when
+ * running interactively, to the log file or stderr. Debug and info
+ * messages are rate limited per logging category.
+ *
+ * Messages are written synchronously after a fork() (the writer thread
+ * only exists in the parent) and when the queue is full. A fatal message
+ * first drains the queue, so what led up to the abort isn't lost.
+ */
+class LogWriter
+{
+    Q_DISABLE_COPY(LogWriter)
+public:
+    static LogWriter *instance();
+
+    void log(QtMsgType type, const QMessageLogContext &context, const QString &prefix, const QString &msg);
+
+private:
+    LogWriter();
+    void shutdown();
+
+    struct Entry {
+        QtMsgType type = QtDebugMsg;
+        qint64 timestamp = 0; // CLOCK_REALTIME in msecs
+        int line = 0;
+        // the context is only valid during the handler call, so everything is copied
+        std::array<char, 256> file{};
+        std::array<char, 256> function{};
+        std::array<char, 64> category{};
+        QByteArray message;
+    };
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        Entry entry;
+    };
+
+    struct RateLimit {
+        qint64 windowStart = 0;
+        int count = 0;
+        int suppressed = 0;
+    };
+
+    // "hh:mm:ss" only changes once a second, so only the milliseconds are formatted per message
+    struct TimestampCache {
+        qint64 second = -1;
+        char prefix[16] = {};
+    };
+
+    bool push(Entry &&entry);
+    bool pop(Entry &entry);
+    void run();
+    void write(const Entry &entry, TimestampCache &cache);
+    bool rateLimited(const Entry &entry);
+    void writeJournal(const Entry &entry);
+    void writeStandard(const Entry &entry, TimestampCache &cache);
+
+    static constexpr size_t s_capacity = 1024; // must be a power of two
+    std::array<Cell, s_capacity> m_cells;
+    std::atomic<size_t> m_enqueuePos{0};
+    size_t m_dequeuePos{0}; // only touched by the writer thread
+
+    std::atomic<quint32> m_wakeups{0};
+    std::atomic<bool> m_sleeping{false};
+    std::atomic<bool> m_quit{false};
+    std::atomic<quint64> m_dropped{0};
+
+    // owned by the writer thread
+    QHash<QByteArray, RateLimit> m_rateLimits;
+    TimestampCache m_timestampCache;
+
+    const bool m_interactive;
+    int m_logFd = -1;
+    const pid_t m_pid;
+    std::thread m_thread;
+    std::once_flag m_shutdownOnce;
+};
+}
+
+#endif // PLASMALOGIN_LOGWRITER_H
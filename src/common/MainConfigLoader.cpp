@@ -20,12 +20,8 @@
 #include <QDir>
 #include <QFileInfo>
 
-MainConfig *PlasmaLogin::config()
+static MainConfig *createConfig()
 {
-    static MainConfig *s_instance = nullptr;
-    if (s_instance) {
-        return s_instance;
-    }
     auto cfg = std::make_unique<KConfig>(QStringLiteral(CONFIG_FILE), KConfig::NoGlobals);
     QStringList sources;
     if (!QStringLiteral(SYSTEM_CONFIG_DIR).isEmpty()) {
@@ -47,6 +43,18 @@ MainConfig *PlasmaLogin::config()
         }
     }
     cfg->addConfigSources(sources);
-    s_instance = new MainConfig(std::move(cfg));
+    return new MainConfig(std::move(cfg));
+}
+
+MainConfig *PlasmaLogin::config()
+{
+    // function local statics are initialized exactly once, even with several threads
+    static MainConfig *const s_instance = createConfig();
     return s_instance;
 }
+
+QRecursiveMutex &PlasmaLogin::configLock()
+{
+    static QRecursiveMutex s_lock;
+    return s_lock;
+}
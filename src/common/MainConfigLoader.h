@@ -18,7 +18,15 @@
 
 #include "mainconfig.h"
 
+#include <QMutex>
+
 namespace PlasmaLogin
 {
 MainConfig *config();
+
+/**
+ * The daemon runs every seat on its own thread. Hold this lock while
+ * reloading the configuration or reading values from it there.
+ */
+QRecursiveMutex &configLock();
 };
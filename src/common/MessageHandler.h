@@ -18,117 +18,17 @@
 #ifndef PLASMALOGIN_MESSAGEHANDLER_H
 #define PLASMALOGIN_MESSAGEHANDLER_H
 
-#include "Constants.h"
+#include "LogWriter.h"
 
-#include <QDateTime>
-#include <QDir>
-#include <QFile>
-#include <QStandardPaths>
-
-#include <stdio.h>
-#include <unistd.h>
-
-#include <systemd/sd-journal.h>
+#include <QString>
 
 namespace PLASMALOGIN
 {
-static void journaldLogger(QtMsgType type, const QMessageLogContext &context, const QString &msg)
-{
-    int priority = LOG_INFO;
-    switch (type) {
-    case QtDebugMsg:
-        priority = LOG_DEBUG;
-        break;
-    case QtInfoMsg:
-        priority = LOG_INFO;
-        break;
-    case QtWarningMsg:
-        priority = LOG_WARNING;
-        break;
-    case QtCriticalMsg:
-        priority = LOG_CRIT;
-        break;
-    case QtFatalMsg:
-        priority = LOG_ALERT;
-        break;
-    }
-
-    char fileBuffer[PATH_MAX + sizeof("CODE_FILE=")];
-    snprintf(fileBuffer, sizeof(fileBuffer), "CODE_FILE=%s", context.file ? context.file : "unknown");
-
-    char lineBuffer[32];
-    snprintf(lineBuffer, sizeof(lineBuffer), "CODE_LINE=%d", context.line);
-
-    sd_journal_print_with_location(priority, fileBuffer, lineBuffer, context.function ? context.function : "unknown", "%s", qPrintable(msg));
-}
-
-static void standardLogger(QtMsgType type, const QString &msg)
-{
-    static QFile file(QStringLiteral(LOG_FILE));
-
-    // Try to open the log file if we're not outputting to a terminal
-    if (!file.isOpen() && !isatty(STDERR_FILENO)) {
-        if (!file.open(QFile::Append | QFile::WriteOnly))
-            file.open(QFile::Truncate | QFile::WriteOnly);
-
-        // If we can't open the file, create it in a writable location
-        // It will look spmething like ~/.local/share/$appname/plasmalogin.log
-        // or for the plasmalogin user /var/lib/plasmalogin/.local/share/$appname/plasmalogin.log
-        if (!file.isOpen()) {
-            QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
-            file.setFileName(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QLatin1String("/plasmalogin.log"));
-            if (!file.open(QFile::Append | QFile::WriteOnly))
-                file.open(QFile::Truncate | QFile::WriteOnly);
-        }
-    }
-
-    // create timestamp
-    QString timestamp = QDateTime::currentDateTime().toString(QStringLiteral("hh:mm:ss.zzz"));
-
-    // set log priority
-    QString logPriority = QStringLiteral("(II)");
-    switch (type) {
-    case QtDebugMsg:
-        break;
-    case QtWarningMsg:
-        logPriority = QStringLiteral("(WW)");
-        break;
-    case QtCriticalMsg:
-    case QtFatalMsg:
-        logPriority = QStringLiteral("(EE)");
-        break;
-    default:
-        break;
-    }
-
-    // prepare log message
-    QString logMessage = QStringLiteral("[%1] %2 %3\n").arg(timestamp).arg(logPriority).arg(msg);
-
-    // log message
-    if (file.isOpen()) {
-        file.write(logMessage.toLocal8Bit());
-        file.flush();
-    } else {
-        fputs(qPrintable(logMessage), stderr);
-        fflush(stderr);
-    }
-}
-
 static void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &prefix, const QString &msg)
 {
-    // don't log to journald if running interactively, this is likely
-    // the case when running plasmalogin in test mode
-    static bool isInteractive = isatty(STDERR_FILENO) && qgetenv("USER") != "plasmalogin";
-    if (!isInteractive) {
-        // log to journald
-        journaldLogger(type, context, msg);
-        return;
-    }
-    // prepend program name
-    QString logMessage = prefix + msg;
-
-    // log to file or stderr
-    standardLogger(type, logMessage);
+    // formatting and writing happen on the LogWriter thread, either to
+    // journald or, when running interactively, to the log file or stderr
+    LogWriter::instance()->log(type, context, prefix, msg);
 }
 
 void DaemonMessageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
@@ -30,6 +30,8 @@ enum class DaemonMessages {
     LoginSucceeded,
     LoginFailed,
     InformationMessage,
+    LoginBusy, // the login can't be handled now, nothing was attempted
+    LoginCancelled, // superseded by a newer login of the same greeter
 };
 
 enum class SessionType {
@@ -17,6 +17,7 @@
 #include "DaemonApp.h"
 
 #include "DisplayManager.h"
+#include "Metrics.h"
 #include "SeatManager.h"
 #include <KSignalHandler>
 
@@ -47,6 +48,9 @@ DaemonApp::DaemonApp(int &argc, char **argv)
     // create display manager
     m_displayManager = new DisplayManager(this);
 
+    // create metrics, after DisplayManager has registered the service
+    m_metrics = new Metrics(this);
+
     // create seat manager
     m_seatManager = new SeatManager(this);
 
@@ -63,6 +67,14 @@ DaemonApp::DaemonApp(int &argc, char **argv)
             this->quit();
         }
     });
+    // only needed for autologin, ask now so the answer is there once a seat wants it
+    QDBusMessage firstBootMsg = QDBusMessage::createMethodCall(QStringLiteral("org.freedesktop.systemd1"),
+                                                               QStringLiteral("/org/freedesktop/systemd1"),
+                                                               QStringLiteral("org.freedesktop.DBus.Properties"),
+                                                               QStringLiteral("Get"));
+    firstBootMsg << QStringLiteral("org.freedesktop.systemd1.Manager") << QStringLiteral("SoftRebootsCount");
+    m_firstBootReply = QDBusConnection::systemBus().asyncCall(firstBootMsg);
+
     // log message
     qDebug() << "Starting...";
 
@@ -75,6 +87,11 @@ DisplayManager *DaemonApp::displayManager() const
     return m_displayManager;
 }
 
+Metrics *DaemonApp::metrics() const
+{
+    return m_metrics;
+}
+
 SeatManager *DaemonApp::seatManager() const
 {
     return m_seatManager;
@@ -90,29 +107,25 @@ bool DaemonApp::isFirstBoot()
     // Whether this boot is a first boot (no soft reboot since power-on) is a
     // machine-global fact that cannot change while the daemon runs, so resolve
     // it once and cache the answer — including the "treat as first boot" error
-    // paths, which must stay sticky too.
+    // paths, which must stay sticky too. The query was sent from the
+    // constructor, usually it has been answered by now.
+    QMutexLocker locker(&m_isFirstBootMutex);
     if (m_isFirstBoot.has_value()) {
         return m_isFirstBoot.value();
     }
 
-    QDBusMessage msg = QDBusMessage::createMethodCall(QStringLiteral("org.freedesktop.systemd1"),
-                                                      QStringLiteral("/org/freedesktop/systemd1"),
-                                                      QStringLiteral("org.freedesktop.DBus.Properties"),
-                                                      QStringLiteral("Get"));
-
-    msg << QStringLiteral("org.freedesktop.systemd1.Manager") << QStringLiteral("SoftRebootsCount");
-
-    const QDBusMessage reply = QDBusConnection::systemBus().call(msg);
+    m_firstBootReply.waitForFinished();
 
-    if (reply.type() == QDBusMessage::ErrorMessage) {
-        qWarning() << "DBus error:" << reply.errorName() << "-" << reply.errorMessage();
+    if (m_firstBootReply.isError()) {
+        const QDBusError error = m_firstBootReply.error();
+        qWarning() << "DBus error:" << error.name() << "-" << error.message();
         m_isFirstBoot = true;
         return m_isFirstBoot.value();
     }
 
-    const QVariant soft_reboot_count = qvariant_cast<QDBusVariant>(reply.arguments().at(0)).variant();
+    const QVariant soft_reboot_count = m_firstBootReply.value().variant();
     if (!soft_reboot_count.isValid()) {
-        qWarning() << "DBus variant is invalid:" << reply;
+        qWarning() << "DBus variant is invalid:" << m_firstBootReply.reply();
         m_isFirstBoot = true;
         return m_isFirstBoot.value();
     }
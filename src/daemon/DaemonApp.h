@@ -18,8 +18,11 @@
 #define PLASMALOGIN_DAEMONAPP_H
 
 #include <QCoreApplication>
+#include <QDBusPendingReply>
+#include <QDBusVariant>
 #include <QtCore>
 
+#include <atomic>
 #include <optional>
 
 #define daemonApp DaemonApp::instance()
@@ -28,6 +31,7 @@ namespace PLASMALOGIN
 {
 class Configuration;
 class DisplayManager;
+class Metrics;
 class SeatManager;
 
 class DaemonApp : public QCoreApplication
@@ -45,6 +49,7 @@ public:
     bool isFirstBoot();
 
     DisplayManager *displayManager() const;
+    Metrics *metrics() const;
     SeatManager *seatManager() const;
 
 public slots:
@@ -53,11 +58,14 @@ public slots:
 private:
     static DaemonApp *self;
 
-    int m_lastSessionId{0};
+    std::atomic<int> m_lastSessionId{0};
 
+    QMutex m_isFirstBootMutex;
+    QDBusPendingReply<QDBusVariant> m_firstBootReply;
     std::optional<bool> m_isFirstBoot;
 
     DisplayManager *m_displayManager{nullptr};
+    Metrics *m_metrics{nullptr};
     SeatManager *m_seatManager{nullptr};
 };
 }
@@ -21,15 +21,25 @@
 #include "DaemonApp.h"
 #include "DisplayManager.h"
 #include "Greeter.h"
+#include "LoginQueue.h"
 #include "MainConfigLoader.h"
+#include "Metrics.h"
 #include "Seat.h"
 #include "SocketServer.h"
 
+#include <QDBusConnection>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
 #include <QDebug>
 #include <QFile>
 #include <QLocalSocket>
+#include <QMutexLocker>
 #include <QTimer>
 
+#include <atomic>
+#include <optional>
+#include <utility>
+
 #include <pwd.h>
 #include <sys/time.h>
 #include <unistd.h>
@@ -37,19 +47,22 @@
 #include <fcntl.h>
 #include <sys/ioctl.h>
 
+#include "LogindDBusTypes.h"
 #include "VirtualTerminal.h"
 #include "config.h"
 
-static int s_ttyFailures = 0;
+#include <Login1Manager.h>
+
+// shared by the displays of all seats
+static std::atomic<int> s_ttyFailures = 0;
 
 namespace PLASMALOGIN
 {
 Display::Display(Seat *parent)
     : QObject(parent)
-    , m_auth(new Auth(this))
+    , m_auth(new Auth(parent->authSocketServer(), this))
     , m_seat(parent)
-    , m_socketServer(new SocketServer(this))
-    , m_greeter(new Greeter(this))
+    , m_loginQueue(new LoginQueue(this))
 {
     if (seat()->canTTY()) {
         m_terminalId = seat()->availableVt();
@@ -64,6 +77,56 @@ Display::Display(Seat *parent)
     connect(m_auth, &Auth::finished, this, &Display::slotHelperFinished);
     connect(m_auth, &Auth::info, this, &Display::slotAuthInfo);
     connect(m_auth, &Auth::error, this, &Display::slotAuthError);
+    connect(m_auth, &Auth::phaseFinished, this, [this](const QString &phase, qint64 msecs) {
+        daemonApp->metrics()->observeHelperPhase(phase, msecs, seat()->name(), false);
+    });
+
+    // run and answer the logins of the greeter, see LoginQueue
+    connect(m_loginQueue, &LoginQueue::start, this, [this](const LoginQueue::Request &request) {
+        if (!startAuth(request.user, request.password, request.session)) {
+            m_loginQueue->startFailed();
+        }
+    });
+    connect(m_loginQueue, &LoginQueue::stopHelper, this, [this] {
+        qDebug() << "Cancelling the login of" << m_auth->user() << "for a newer attempt";
+        m_auth->stop();
+    });
+    connect(m_loginQueue, &LoginQueue::succeeded, this, [this](QObject *client) {
+        emit loginSucceeded(static_cast<QLocalSocket *>(client));
+    });
+    connect(m_loginQueue, &LoginQueue::failed, this, [this](QObject *client) {
+        emit loginFailed(static_cast<QLocalSocket *>(client));
+    });
+    connect(m_loginQueue, &LoginQueue::cancelled, this, [this](QObject *client) {
+        m_socketServer->loginCancelled(static_cast<QLocalSocket *>(client));
+    });
+    connect(m_loginQueue, &LoginQueue::busy, this, [this](QObject *client) {
+        m_socketServer->loginBusy(static_cast<QLocalSocket *>(client));
+    });
+}
+
+Display::~Display()
+{
+    disconnect(m_auth, &Auth::finished, this, &Display::slotHelperFinished);
+
+    // Normally we are only deleted once stopped() has been emitted. Otherwise
+    // signal both helpers now so they shut down in parallel, Auth's destructor
+    // reaps them.
+    if (m_greeter) {
+        m_greeter->stop();
+    }
+    m_auth->stop();
+}
+
+void Display::createSocketServerAndGreeter()
+{
+    // An autologin display only needs them once autologin fails
+    if (m_greeter) {
+        return;
+    }
+
+    m_socketServer = new SocketServer(this);
+    m_greeter = new Greeter(this);
 
     // connect login signal
     connect(m_socketServer, &SocketServer::login, this, &Display::login);
@@ -72,11 +135,24 @@ Display::Display(Seat *parent)
     connect(this, &Display::loginFailed, m_socketServer, &SocketServer::loginFailed);
     connect(this, &Display::loginSucceeded, m_socketServer, &SocketServer::loginSucceeded);
 
+    connect(m_greeter, &Greeter::stopped, this, &Display::checkStopped);
+    connect(m_greeter, &Greeter::stopped, this, [this] {
+        if (!m_stopping && m_sessionStarted && m_auth->isActive()) {
+            emit greeterHandedOver();
+        }
+    });
+    connect(m_greeter, &Greeter::started, this, &Display::greeterStarted);
+    connect(m_greeter, &Greeter::failed, this, [this] {
+        daemonApp->metrics()->increment(QStringLiteral("greeter_restarts_total"), seat()->name());
+    });
     connect(m_greeter, &Greeter::failed, this, &Display::stop);
     connect(m_greeter, &Greeter::ttyFailed, this, [this] {
-        ++s_ttyFailures;
-        if (s_ttyFailures > 5) {
-            QCoreApplication::exit(23);
+        daemonApp->metrics()->increment(QStringLiteral("greeter_tty_failures_total"), seat()->name());
+        daemonApp->metrics()->increment(QStringLiteral("greeter_restarts_total"), seat()->name());
+        if (++s_ttyFailures > 5) {
+            QMetaObject::invokeMethod(qApp, [] {
+                QCoreApplication::exit(23);
+            });
         }
         // It might be the case that we are trying a tty that has been taken over by a
         // different process. In such a case, switch back to the initial one and try again.
@@ -85,12 +161,6 @@ Display::Display(Seat *parent)
     });
 }
 
-Display::~Display()
-{
-    disconnect(m_auth, &Auth::finished, this, &Display::slotHelperFinished);
-    stop();
-}
-
 int Display::terminalId() const
 {
     return (m_auth->isActive() ? m_sessionTerminalId : m_terminalId).tty();
@@ -106,6 +176,21 @@ Seat *Display::seat() const
     return m_seat;
 }
 
+bool Display::isStandby() const
+{
+    return m_standby;
+}
+
+void Display::setStandby(bool standby)
+{
+    m_standby = standby;
+}
+
+bool Display::hasSession() const
+{
+    return m_sessionStarted;
+}
+
 void Display::setAutoLogin(const QString &user, const QString &session)
 {
     m_autologinUser = user;
@@ -150,12 +235,20 @@ bool Display::start()
 
 void Display::startSocketServerAndGreeter()
 {
+    createSocketServerAndGreeter();
+
     // start socket server
     m_socketServer->start(QString());
     // change the owner and group of the socket to avoid permission denied errors
-    struct passwd *pw = getpwnam("plasmalogin");
-    if (pw) {
-        if (chown(qPrintable(m_socketServer->socketAddress()), pw->pw_uid, pw->pw_gid) == -1) {
+    // the greeter user doesn't change while we run, resolve it only once
+    static const std::optional<std::pair<uid_t, gid_t>> greeterIds = []() -> std::optional<std::pair<uid_t, gid_t>> {
+        if (struct passwd *pw = getpwnam("plasmalogin")) {
+            return std::make_pair(pw->pw_uid, pw->pw_gid);
+        }
+        return std::nullopt;
+    }();
+    if (greeterIds) {
+        if (chown(qPrintable(m_socketServer->socketAddress()), greeterIds->first, greeterIds->second) == -1) {
             qWarning() << "Failed to change owner of the socket";
             return;
         }
@@ -171,7 +264,8 @@ bool Display::handleAutologinFailure()
 {
     qWarning() << "Autologin failed!";
     m_auth->setAutologin(false);
-    // For late autologin handling only the greeter needs to be started.
+    // For late autologin handling only the greeter needs to be started,
+    // it and the socket server are created on the way.
 
     QMetaObject::invokeMethod(this, &Display::displayServerStarted, Qt::QueuedConnection);
     return true;
@@ -192,16 +286,29 @@ void Display::stop()
         return;
     }
 
-    // stop the greeter
-    m_greeter->stop();
+    // reset flag
+    m_started = false;
+    m_stopping = true;
 
+    // ask the greeter and the session helper to quit, they shut down in
+    // parallel and checkStopped() emits stopped() once both are gone
+    if (m_greeter) {
+        m_greeter->stop();
+        m_socketServer->stop();
+    }
     m_auth->stop();
+    m_loginQueue->clear();
 
-    // stop socket server
-    m_socketServer->stop();
+    checkStopped();
+}
 
-    // reset flag
-    m_started = false;
+void Display::checkStopped()
+{
+    if (!m_stopping || (m_greeter && m_greeter->isRunning()) || m_auth->isActive()) {
+        return;
+    }
+
+    m_stopping = false;
 
     // emit signal
     emit stopped();
@@ -209,17 +316,22 @@ void Display::stop()
 
 void Display::login(QLocalSocket *socket, const QString &user, const QString &password, const Session &session)
 {
-    m_socket = socket;
-
     // the PLASMALOGIN user has special privileges that skip password checking so that we can load the greeter
     // block ever trying to log in as the PLASMALOGIN user
     if (user == QLatin1String("plasmalogin")) {
-        emit loginFailed(m_socket);
+        emit loginFailed(socket);
         return;
     }
 
-    // authenticate
-    startAuth(user, password, session);
+    m_loginQueue->login({socket, user, password, session}, m_auth->isActive());
+}
+
+QLocalSocket *Display::loginSocket() const
+{
+    if (m_loginQueue->isCancelling()) {
+        return nullptr;
+    }
+    return static_cast<QLocalSocket *>(m_loginQueue->current());
 }
 
 bool Display::startAuth(const QString &user, const QString &password, const Session &session)
@@ -258,7 +370,7 @@ bool Display::startAuth(const QString &user, const QString &password, const Sess
 
     m_sessionTerminalId = {m_terminalId.tty(), m_terminalId.ttyFd().duplicate()};
 
-    if (m_greeter->isRunning()) {
+    if (m_greeter && m_greeter->isRunning()) {
         // Create a new VT when we need to have another compositor running
         if (seat()->canTTY()) {
             m_sessionTerminalId = VirtualTerminal::setUpNewVt();
@@ -268,8 +380,11 @@ bool Display::startAuth(const QString &user, const QString &password, const Sess
     // some information
     qDebug() << "Session" << m_sessionName << "selected, command:" << session.exec() << "for VT" << m_sessionTerminalId.tty() << session.xdgSessionType();
 
-    QProcessEnvironment env;
-    env.insert(QStringLiteral("PATH"), PlasmaLogin::config()->defaultPath());
+    Environment env;
+    {
+        QMutexLocker locker(&PlasmaLogin::configLock());
+        env.insert(QStringLiteral("PATH"), PlasmaLogin::config()->defaultPath());
+    }
     env.insert(QStringLiteral("XDG_SEAT_PATH"), daemonApp->displayManager()->seatPath(seat()->name()));
     env.insert(QStringLiteral("XDG_SESSION_PATH"), daemonApp->displayManager()->sessionPath(QStringLiteral("Session%1").arg(daemonApp->newSessionId())));
     env.insert(QStringLiteral("DESKTOP_SESSION"), session.desktopSession());
@@ -296,6 +411,11 @@ bool Display::startAuth(const QString &user, const QString &password, const Sess
 
 void Display::slotAuthenticationFinished(const QString &user, bool success)
 {
+    daemonApp->metrics()->increment(QStringLiteral("login_attempts_total"), seat()->name());
+    if (!success) {
+        daemonApp->metrics()->increment(QStringLiteral("login_failures_total"), seat()->name());
+    }
+
     if (m_auth->autologin() && !success) {
         handleAutologinFailure();
         return;
@@ -307,39 +427,38 @@ void Display::slotAuthenticationFinished(const QString &user, bool success)
         if (!m_reuseSessionId.isNull()) {
             seat()->activateSession(m_reuseSessionId);
         }
-
-        if (m_socket) {
-            emit loginSucceeded(m_socket);
-        }
-    } else if (m_socket) {
+    } else if (loginSocket()) {
         qDebug() << "Authentication for user " << user << " failed";
-        emit loginFailed(m_socket);
     }
-    m_socket = nullptr;
+
+    // a failed login stays pending until its helper has exited
+    m_loginQueue->authenticated(success);
 }
 
 void Display::slotAuthInfo(const QString &message, Auth::Info info)
 {
     qWarning() << "Authentication information:" << info << message;
 
-    if (!m_socket) {
+    QLocalSocket *socket = loginSocket();
+    if (!socket) {
         return;
     }
 
-    m_socketServer->informationMessage(m_socket, message);
+    m_socketServer->informationMessage(socket, message);
 }
 
 void Display::slotAuthError(const QString &message, Auth::Error error)
 {
     qWarning() << "Authentication error:" << error << message;
 
-    if (!m_socket) {
+    QLocalSocket *socket = loginSocket();
+    if (!socket) {
         return;
     }
 
-    m_socketServer->informationMessage(m_socket, message);
+    m_socketServer->informationMessage(socket, message);
     if (error == Auth::ERROR_AUTHENTICATION) {
-        emit loginFailed(m_socket);
+        emit loginFailed(socket);
     }
 }
 
@@ -350,9 +469,18 @@ void Display::slotHelperFinished(Auth::HelperExitStatus status)
     // we want to avoid greeter from restarting when an authentication
     // error happens (in this case we want to show the message from the
     // greeter
-    if (status != Auth::HELPER_AUTH_ERROR) {
+    if (m_stopping) {
+        checkStopped();
+        return;
+    }
+
+    if (!m_loginQueue->isCancelling() && status != Auth::HELPER_AUTH_ERROR) {
         stop();
+        return;
     }
+
+    // answers a cancelled login and starts the next queued one
+    m_loginQueue->helperFinished();
 }
 
 void Display::slotRequestChanged()
@@ -370,10 +498,91 @@ void Display::slotRequestChanged()
 void Display::slotSessionStarted(bool success)
 {
     qDebug() << "Session started" << success;
-    if (success) {
+    if (!success) {
+        return;
+    }
+
+    m_sessionStarted = true;
+    if (!m_greeter || !m_greeter->isRunning()) {
+        emit greeterHandedOver();
+        return;
+    }
+
+    // The greeter is stopped as soon as logind reports the session in the
+    // foreground. Without that a fixed delay has to do, and it stays as the
+    // upper bound in case the session never becomes active.
+    const QString sessionId = m_auth->sessionId();
+    if (Logind::isAvailable() && !sessionId.isEmpty()) {
+        stopGreeterOnceSessionActive(sessionId);
+        QTimer::singleShot(30000, m_greeter, &Greeter::stop);
+    } else {
         QTimer::singleShot(5000, m_greeter, &Greeter::stop);
     }
 }
+
+void Display::stopGreeterOnceSessionActive(const QString &sessionId)
+{
+    OrgFreedesktopLogin1ManagerInterface manager(Logind::serviceName(), Logind::managerPath(), QDBusConnection::systemBus());
+    QDBusPendingReply<QDBusObjectPath> reply = manager.GetSession(sessionId);
+    auto watcher = new QDBusPendingCallWatcher(reply, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, watcher, sessionId]() {
+        watcher->deleteLater();
+        QDBusPendingReply<QDBusObjectPath> reply = *watcher;
+        if (reply.isError()) {
+            qWarning() << "Could not find session" << sessionId << "to wait for:" << reply.error().message();
+            QTimer::singleShot(5000, m_greeter, &Greeter::stop);
+            return;
+        }
+
+        m_watchedSessionPath = reply.value().path();
+        QDBusConnection::systemBus().connect(Logind::serviceName(),
+                                             m_watchedSessionPath,
+                                             QStringLiteral("org.freedesktop.DBus.Properties"),
+                                             QStringLiteral("PropertiesChanged"),
+                                             this,
+                                             SLOT(sessionPropertiesChanged(QString, QVariantMap, QStringList)));
+
+        // it may have become active before we started listening
+        QDBusMessage msg = QDBusMessage::createMethodCall(Logind::serviceName(),
+                                                          m_watchedSessionPath,
+                                                          QStringLiteral("org.freedesktop.DBus.Properties"),
+                                                          QStringLiteral("Get"));
+        msg << Logind::sessionIfaceName() << QStringLiteral("Active");
+        auto activeWatcher = new QDBusPendingCallWatcher(QDBusConnection::systemBus().asyncCall(msg), this);
+        connect(activeWatcher, &QDBusPendingCallWatcher::finished, this, [this, activeWatcher]() {
+            activeWatcher->deleteLater();
+            QDBusPendingReply<QDBusVariant> reply = *activeWatcher;
+            if (!reply.isError() && reply.value().variant().toBool()) {
+                sessionPropertiesChanged(Logind::sessionIfaceName(), {{QStringLiteral("Active"), true}}, {});
+            }
+        });
+    });
+}
+
+void Display::sessionPropertiesChanged(const QString &interface, const QVariantMap &changedProperties, const QStringList &invalidatedProperties)
+{
+    Q_UNUSED(invalidatedProperties);
+    if (interface != Logind::sessionIfaceName() || m_watchedSessionPath.isEmpty()) {
+        return;
+    }
+
+    if (!changedProperties.value(QStringLiteral("Active")).toBool()) {
+        return;
+    }
+
+    qDebug() << "Session" << m_watchedSessionPath << "is active, stopping the greeter";
+    QDBusConnection::systemBus().disconnect(Logind::serviceName(),
+                                            m_watchedSessionPath,
+                                            QStringLiteral("org.freedesktop.DBus.Properties"),
+                                            QStringLiteral("PropertiesChanged"),
+                                            this,
+                                            SLOT(sessionPropertiesChanged(QString, QVariantMap, QStringList)));
+    m_watchedSessionPath.clear();
+
+    if (m_greeter) {
+        m_greeter->stop();
+    }
+}
 }
 
 #include "moc_Display.cpp"
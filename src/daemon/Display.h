@@ -36,6 +36,7 @@ class DisplayServer;
 class Seat;
 class SocketServer;
 class Greeter;
+class LoginQueue;
 
 class Display : public QObject
 {
@@ -56,6 +57,18 @@ public:
     Seat *seat() const;
     void setAutoLogin(const QString &user, const QString &session);
 
+    /**
+     * A standby display starts its greeter without switching to its VT,
+     * the seat switches to it once the current session ends.
+     */
+    bool isStandby() const;
+    void setStandby(bool standby);
+
+    /**
+     * True once a user session has been started on this display
+     */
+    bool hasSession() const;
+
 public slots:
     bool start();
     void stop();
@@ -66,16 +79,35 @@ public slots:
 signals:
     void stopped();
 
+    /**
+     * Emitted once the user session has started and this display's greeter
+     * has shut down.
+     */
+    void greeterHandedOver();
+
+    /**
+     * Emitted once the greeter session of this display has started.
+     */
+    void greeterStarted();
+
     void loginFailed(QLocalSocket *socket);
     void loginSucceeded(QLocalSocket *socket);
 
 private:
     bool startAuth(const QString &user, const QString &password, const Session &session);
+    // the greeter connection of the running login, while its answer is still due
+    QLocalSocket *loginSocket() const;
+
+    void stopGreeterOnceSessionActive(const QString &sessionId);
 
+    void createSocketServerAndGreeter();
     void startSocketServerAndGreeter();
     bool handleAutologinFailure();
 
     bool m_started{false};
+    bool m_stopping{false};
+    bool m_standby{false};
+    bool m_sessionStarted{false};
 
     VirtualTerminal::Terminal m_terminalId;
     VirtualTerminal::Terminal m_sessionTerminalId;
@@ -83,20 +115,24 @@ private:
     QString m_passPhrase;
     QString m_sessionName;
     QString m_reuseSessionId;
+    QString m_watchedSessionPath; // logind object of the session the greeter waits for
 
     Session m_autologinSession;
     QString m_autologinUser;
 
     Auth *m_auth{nullptr};
     Seat *m_seat{nullptr};
+    LoginQueue *m_loginQueue{nullptr};
+    // both are only created once a greeter is needed, autologin skips them
     SocketServer *m_socketServer{nullptr};
-    QPointer<QLocalSocket> m_socket;
     Greeter *m_greeter{nullptr};
 
 private slots:
+    void checkStopped();
     void slotRequestChanged();
     void slotAuthenticationFinished(const QString &user, bool success);
     void slotSessionStarted(bool success);
+    void sessionPropertiesChanged(const QString &interface, const QVariantMap &changedProperties, const QStringList &invalidatedProperties);
     void slotHelperFinished(Auth::HelperExitStatus status);
     void slotAuthInfo(const QString &message, Auth::Info info);
     void slotAuthError(const QString &message, Auth::Error error);
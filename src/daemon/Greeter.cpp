@@ -21,8 +21,12 @@
 #include "Display.h"
 #include "DisplayManager.h"
 #include "MainConfigLoader.h"
+#include "Metrics.h"
 #include "Seat.h"
 
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
 #include <QStandardPaths>
 #include <QtCore/QDebug>
 #include <QtCore/QProcess>
@@ -53,9 +57,11 @@ bool Greeter::start()
         return false;
     }
 
-    QString greeterCommand = QStandardPaths::findExecutable(QStringLiteral("startplasma-login-wayland"));
     // allow overriding for test setups.
-    greeterCommand = qEnvironmentVariable("PLASMALOGIN_GREETER_EXEC", greeterCommand);
+    QString greeterCommand = qEnvironmentVariable("PLASMALOGIN_GREETER_EXEC");
+    if (greeterCommand.isEmpty()) {
+        greeterCommand = findGreeterCommand();
+    }
 
     if (greeterCommand.isEmpty()) {
         qCritical("Could not find greeter");
@@ -64,47 +70,27 @@ bool Greeter::start()
     Q_ASSERT(m_display);
     {
         // authentication
-        m_auth = new Auth(this);
+        m_auth = new Auth(m_display->seat()->authSocketServer(), this);
         m_auth->setVerbose(true);
         connect(m_auth, &Auth::requestChanged, this, &Greeter::onRequestChanged);
         connect(m_auth, &Auth::sessionStarted, this, &Greeter::onSessionStarted);
         connect(m_auth, &Auth::finished, this, &Greeter::onHelperFinished);
         connect(m_auth, &Auth::info, this, &Greeter::authInfo);
         connect(m_auth, &Auth::error, this, &Greeter::authError);
+        connect(m_auth, &Auth::phaseFinished, this, [this](const QString &phase, qint64 msecs) {
+            daemonApp->metrics()->observeHelperPhase(phase, msecs, m_display->seat()->name(), true);
+        });
 
         // greeter environment
-        QProcessEnvironment env;
-        QProcessEnvironment sysenv = QProcessEnvironment::systemEnvironment();
-
-        insertEnvironmentList({QStringLiteral("LANG"),
-                               QStringLiteral("LANGUAGE"),
-                               QStringLiteral("LC_CTYPE"),
-                               QStringLiteral("LC_NUMERIC"),
-                               QStringLiteral("LC_TIME"),
-                               QStringLiteral("LC_COLLATE"),
-                               QStringLiteral("LC_MONETARY"),
-                               QStringLiteral("LC_MESSAGES"),
-                               QStringLiteral("LC_PAPER"),
-                               QStringLiteral("LC_NAME"),
-                               QStringLiteral("LC_ADDRESS"),
-                               QStringLiteral("LC_TELEPHONE"),
-                               QStringLiteral("LC_MEASUREMENT"),
-                               QStringLiteral("LC_IDENTIFICATION"),
-                               QStringLiteral("LD_LIBRARY_PATH"),
-                               QStringLiteral("QML2_IMPORT_PATH"),
-                               QStringLiteral("QT_PLUGIN_PATH"),
-                               QStringLiteral("XDG_DATA_DIRS")},
-                              sysenv,
-                              env);
-
-        env.insert(QStringLiteral("PATH"), PlasmaLogin::config()->defaultPath());
-        env.insert(QStringLiteral("XDG_SEAT"), m_display->seat()->name());
-        env.insert(QStringLiteral("XDG_SEAT_PATH"), daemonApp->displayManager()->seatPath(m_display->seat()->name()));
+        Environment env = baseEnvironment(m_display->seat()->name());
+        {
+            QMutexLocker locker(&PlasmaLogin::configLock());
+            env.insert(QStringLiteral("PATH"), PlasmaLogin::config()->defaultPath());
+        }
         env.insert(QStringLiteral("XDG_SESSION_PATH"), daemonApp->displayManager()->sessionPath(QStringLiteral("Session%1").arg(daemonApp->newSessionId())));
         if (m_display->seat()->name() == QLatin1String("seat0") && m_display->terminalId() > 0) {
             env.insert(QStringLiteral("XDG_VTNR"), QString::number(m_display->terminalId()));
         }
-        env.insert(QStringLiteral("XDG_SESSION_CLASS"), QStringLiteral("greeter"));
         env.insert(QStringLiteral("XDG_SESSION_TYPE"), m_display->sessionType());
         env.insert(QStringLiteral("SDDM_SOCKET"), m_socket);
 
@@ -116,6 +102,7 @@ bool Greeter::start()
         // start greeter
         m_auth->setUser(QStringLiteral("plasmalogin"));
         m_auth->setGreeter(true);
+        m_auth->setBackground(m_display->isStandby());
         m_auth->setSession(greeterCommand);
         m_auth->start();
     }
@@ -124,19 +111,62 @@ bool Greeter::start()
     return true;
 }
 
-void Greeter::insertEnvironmentList(QStringList names, QProcessEnvironment sourceEnv, QProcessEnvironment &targetEnv)
+QString Greeter::findGreeterCommand()
 {
-    for (QStringList::const_iterator it = names.constBegin(); it != names.constEnd(); ++it) {
-        if (sourceEnv.contains(*it)) {
-            targetEnv.insert(*it, sourceEnv.value(*it));
-        }
+    // Resolved once, a respawn only checks that it's still there
+    static QMutex mutex;
+    static QString command;
+    QMutexLocker locker(&mutex);
+    if (command.isEmpty() || !QFileInfo(command).isExecutable()) {
+        command = QStandardPaths::findExecutable(QStringLiteral("startplasma-login-wayland"));
+    }
+    return command;
+}
+
+Environment Greeter::baseEnvironment(const QString &seat)
+{
+    // The parts of the greeter environment that stay the same for every
+    // greeter started on a seat, only the per-session variables are added
+    // on top of a shared copy.
+    static QMutex mutex;
+    static QHash<QString, Environment> cache;
+    QMutexLocker locker(&mutex);
+    auto it = cache.constFind(seat);
+    if (it != cache.constEnd()) {
+        return *it;
     }
+
+    Environment env;
+    env.insertFromSystem({QStringLiteral("LANG"),
+                          QStringLiteral("LANGUAGE"),
+                          QStringLiteral("LC_CTYPE"),
+                          QStringLiteral("LC_NUMERIC"),
+                          QStringLiteral("LC_TIME"),
+                          QStringLiteral("LC_COLLATE"),
+                          QStringLiteral("LC_MONETARY"),
+                          QStringLiteral("LC_MESSAGES"),
+                          QStringLiteral("LC_PAPER"),
+                          QStringLiteral("LC_NAME"),
+                          QStringLiteral("LC_ADDRESS"),
+                          QStringLiteral("LC_TELEPHONE"),
+                          QStringLiteral("LC_MEASUREMENT"),
+                          QStringLiteral("LC_IDENTIFICATION"),
+                          QStringLiteral("LD_LIBRARY_PATH"),
+                          QStringLiteral("QML2_IMPORT_PATH"),
+                          QStringLiteral("QT_PLUGIN_PATH"),
+                          QStringLiteral("XDG_DATA_DIRS")});
+    env.insert(QStringLiteral("XDG_SEAT"), seat);
+    env.insert(QStringLiteral("XDG_SEAT_PATH"), daemonApp->displayManager()->seatPath(seat));
+    env.insert(QStringLiteral("XDG_SESSION_CLASS"), QStringLiteral("greeter"));
+
+    cache.insert(seat, env);
+    return env;
 }
 
 void Greeter::stop()
 {
-    // check flag
-    if (!m_started) {
+    // the helper may still be authenticating, so don't rely on m_started here
+    if (!isRunning()) {
         return;
     }
 
@@ -178,6 +208,7 @@ void Greeter::onSessionStarted(bool success)
     // log message
     if (success) {
         qDebug() << "Greeter session started successfully";
+        Q_EMIT started();
     } else {
         qDebug() << "Greeter session failed to start";
     }
@@ -195,6 +226,8 @@ void Greeter::onHelperFinished(Auth::HelperExitStatus status)
     m_auth->deleteLater();
     m_auth = nullptr;
 
+    Q_EMIT stopped();
+
     if (status == Auth::HELPER_TTY_ERROR) {
         Q_EMIT ttyFailed();
     } else if (status == Auth::HELPER_SESSION_ERROR) {
@@ -53,6 +53,14 @@ private slots:
     void authError(const QString &message, Auth::Error error);
 
 signals:
+    /**
+     * Emitted once the greeter helper has exited, after stop() or on its own.
+     */
+    void stopped();
+    /**
+     * Emitted once the greeter session has been started by the helper.
+     */
+    void started();
     void ttyFailed();
     void failed();
     void displayServerFailed();
@@ -66,7 +74,8 @@ private:
     Auth *m_auth{nullptr};
     QProcess *m_process{nullptr};
 
-    static void insertEnvironmentList(QStringList names, QProcessEnvironment sourceEnv, QProcessEnvironment &targetEnv);
+    static QString findGreeterCommand();
+    static Environment baseEnvironment(const QString &seat);
 };
 }
 
@@ -0,0 +1,169 @@
+/***************************************************************************
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ ***************************************************************************/
+
+
+#include "LoginQueue.h"
+
+#include <utility>
+
+namespace PLASMALOGIN
+{
+LoginQueue::LoginQueue(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QObject *LoginQueue::current() const
+{
+    return m_current;
+}
+
+bool LoginQueue::isPending() const
+{
+    return m_pending;
+}
+
+bool LoginQueue::isCancelling() const
+{
+    return m_cancelling;
+}
+
+int LoginQueue::queued() const
+{
+    return m_queue.size();
+}
+
+void LoginQueue::login(const Request &request, bool helperActive)
+{
+    if (!helperActive) {
+        begin(request);
+        return;
+    }
+
+    // a user session (or autologin) owns the helper, nothing to wait for
+    if (!m_pending) {
+        Q_EMIT busy(request.client);
+        return;
+    }
+
+    // A newer attempt of the same greeter supersedes its older ones, others
+    // wait for their turn.
+    for (auto it = m_queue.begin(); it != m_queue.end();) {
+        if (it->client == request.client) {
+            Q_EMIT cancelled(request.client);
+            it = m_queue.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (m_queue.size() >= maxQueued) {
+        Q_EMIT busy(request.client);
+        return;
+    }
+    m_queue.append(request);
+
+    // A login that has already been answered keeps the helper until it exits,
+    // the new attempt starts then.
+    if (m_current && m_current == request.client && !m_cancelling) {
+        m_cancelling = true;
+        Q_EMIT stopHelper();
+    }
+}
+
+void LoginQueue::startFailed()
+{
+    QObject *client = m_current;
+    m_current = nullptr;
+    m_pending = false;
+    m_cancelling = false;
+    if (client) {
+        Q_EMIT failed(client);
+    }
+    startNext();
+}
+
+void LoginQueue::authenticated(bool success)
+{
+    // the answer of a cancelled login doesn't matter anymore, its helper is on the way out
+    if (m_cancelling) {
+        return;
+    }
+
+    QObject *client = m_current;
+    m_current = nullptr;
+
+    if (!success) {
+        // still pending, the helper exits with an authentication error
+        if (client) {
+            Q_EMIT failed(client);
+        }
+        return;
+    }
+
+    // the helper now runs the user session, nothing queued gets its turn
+    m_pending = false;
+    if (client) {
+        Q_EMIT succeeded(client);
+    }
+    const QList<Request> queue = std::exchange(m_queue, {});
+    for (const Request &request : queue) {
+        if (request.client) {
+            Q_EMIT busy(request.client);
+        }
+    }
+}
+
+void LoginQueue::helperFinished()
+{
+    if (m_cancelling && m_current) {
+        Q_EMIT cancelled(m_current);
+    }
+    m_cancelling = false;
+    m_current = nullptr;
+    m_pending = false;
+    startNext();
+}
+
+void LoginQueue::clear()
+{
+    m_queue.clear();
+    m_current = nullptr;
+    m_pending = false;
+    m_cancelling = false;
+}
+
+void LoginQueue::begin(const Request &request)
+{
+    m_pending = true;
+    m_current = request.client;
+    Q_EMIT start(request);
+}
+
+void LoginQueue::startNext()
+{
+    while (!m_pending && !m_queue.isEmpty()) {
+        const Request request = m_queue.takeFirst();
+        // the greeter went away while it was waiting
+        if (!request.client) {
+            continue;
+        }
+        begin(request);
+    }
+}
+}
+
+#include "moc_LoginQueue.cpp"
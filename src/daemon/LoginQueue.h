@@ -0,0 +1,96 @@
+/***************************************************************************
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ ***************************************************************************/
+
+
+#ifndef PLASMALOGIN_LOGINQUEUE_H
+#define PLASMALOGIN_LOGINQUEUE_H
+
+#include <QList>
+#include <QObject>
+#include <QPointer>
+
+#include "Session.h"
+
+namespace PLASMALOGIN
+{
+/**
+ * Decides which greeter login runs on the session helper and how the others
+ * are answered. Every Login gets exactly one answer: succeeded, failed,
+ * cancelled or busy.
+ *
+ * It holds no sockets or processes, Display connects its signals to the
+ * helper and to the greeter connections.
+ */
+class LoginQueue : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(LoginQueue)
+public:
+    // a Login message of a greeter connection, waiting for or being authenticated
+    struct Request {
+        QPointer<QObject> client;
+        QString user;
+        QString password;
+        Session session;
+    };
+
+    // logins waiting while another one runs, more are answered with busy()
+    static constexpr int maxQueued = 4;
+
+    explicit LoginQueue(QObject *parent = nullptr);
+
+    // the client of the running login, until it has been answered
+    QObject *current() const;
+    // the helper runs a greeter login that isn't authenticated yet, or failed and is exiting
+    bool isPending() const;
+    // the running login is being stopped for a newer one of the same client
+    bool isCancelling() const;
+    int queued() const;
+
+    /**
+     * A greeter sent Login. @p helperActive tells whether the helper is running,
+     * for a greeter login or for a user session.
+     */
+    void login(const Request &request, bool helperActive);
+    // the helper couldn't be started for the login passed with start()
+    void startFailed();
+    // the helper authenticated the running login, or rejected it
+    void authenticated(bool success);
+    // the helper exited after an authentication error or after stopHelper()
+    void helperFinished();
+    // the display stops, the logins are dropped without an answer
+    void clear();
+
+Q_SIGNALS:
+    void start(const PLASMALOGIN::LoginQueue::Request &request);
+    void stopHelper();
+    void succeeded(QObject *client);
+    void failed(QObject *client);
+    void cancelled(QObject *client);
+    void busy(QObject *client);
+
+private:
+    void begin(const Request &request);
+    void startNext();
+
+    bool m_pending{false};
+    bool m_cancelling{false};
+    QPointer<QObject> m_current;
+    QList<Request> m_queue;
+};
+}
+
+#endif // PLASMALOGIN_LOGINQUEUE_H
@@ -37,6 +37,14 @@ struct Logind {
     {
         return QStringLiteral("org.freedesktop.login1.Seat");
     }
+    static inline QString sessionIfaceName()
+    {
+        return QStringLiteral("org.freedesktop.login1.Session");
+    }
+    static inline QString userIfaceName()
+    {
+        return QStringLiteral("org.freedesktop.login1.User");
+    }
 };
 
 struct SessionInfo {
@@ -0,0 +1,211 @@
+/***************************************************************************
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ ***************************************************************************/
+
+#include "Metrics.h"
+
+#include "MainConfigLoader.h"
+
+#include "metricsadaptor.h"
+
+#include <QDBusConnection>
+#include <QDebug>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+
+const QString METRICS_PATH = QStringLiteral("/org/kde/PlasmaLogin/Metrics");
+const QString METRICS_PREFIX = QStringLiteral("plasmalogin_");
+
+namespace PLASMALOGIN
+{
+static QString seriesName(const QString &name, const QString &seat, const QString &extraLabel = QString())
+{
+    QStringList labels;
+    if (!seat.isEmpty()) {
+        labels << QStringLiteral("seat=\"%1\"").arg(seat);
+    }
+    if (!extraLabel.isEmpty()) {
+        labels << extraLabel;
+    }
+    if (labels.isEmpty()) {
+        return METRICS_PREFIX + name;
+    }
+    return METRICS_PREFIX + name + QLatin1Char('{') + labels.join(QLatin1Char(',')) + QLatin1Char('}');
+}
+
+Metrics::Metrics(QObject *parent)
+    : QObject(parent)
+    , m_writeTimer(new QTimer(this))
+{
+    // create adaptor
+    new MetricsAdaptor(this);
+
+    // register object, the service name is owned by DisplayManager
+    QDBusConnection::systemBus().registerObject(METRICS_PATH, this);
+
+    // coalesce bursts of updates into one write of the text file
+    m_writeTimer->setSingleShot(true);
+    m_writeTimer->setInterval(1000);
+    connect(m_writeTimer, &QTimer::timeout, this, &Metrics::writeTextFile);
+}
+
+void Metrics::increment(const QString &name, const QString &seat)
+{
+    // seats run on their own threads, the series are only touched on ours
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, name, seat] {
+            increment(name, seat);
+        });
+        return;
+    }
+
+    ++m_counters[name][seat];
+    scheduleWrite();
+}
+
+void Metrics::observe(const QString &name, qint64 msecs, const QString &seat)
+{
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, name, msecs, seat] {
+            observe(name, msecs, seat);
+        });
+        return;
+    }
+
+    msecs = qMax<qint64>(msecs, 0);
+
+    Histogram &histogram = m_histograms[name][seat];
+    auto it = std::lower_bound(s_bucketBounds.cbegin(), s_bucketBounds.cend(), msecs);
+    ++histogram.buckets[std::distance(s_bucketBounds.cbegin(), it)];
+    ++histogram.count;
+    histogram.sum += msecs;
+
+    scheduleWrite();
+}
+
+void Metrics::observeHelperPhase(const QString &phase, qint64 msecs, const QString &seat, bool greeter)
+{
+    // everything after spawning the helper is the PAM conversation and session setup
+    QString name = phase == QLatin1String("spawn") ? QStringLiteral("helper_spawn_seconds") : QStringLiteral("pam_%1_seconds").arg(phase);
+    if (greeter) {
+        name.prepend(QLatin1String("greeter_"));
+    }
+    observe(name, msecs, seat);
+}
+
+QVariantMap Metrics::GetMetrics() const
+{
+    QVariantMap metrics;
+
+    for (auto it = m_counters.cbegin(); it != m_counters.cend(); ++it) {
+        for (auto seat = it->cbegin(); seat != it->cend(); ++seat) {
+            metrics.insert(seriesName(it.key(), seat.key()), seat.value());
+        }
+    }
+
+    for (auto it = m_histograms.cbegin(); it != m_histograms.cend(); ++it) {
+        for (auto seat = it->cbegin(); seat != it->cend(); ++seat) {
+            for (const auto &[series, value] : histogramSamples(it.key(), seat.key(), seat.value())) {
+                metrics.insert(series, value);
+            }
+        }
+    }
+
+    return metrics;
+}
+
+QString Metrics::ExportPrometheus() const
+{
+    QString text;
+
+    for (auto it = m_counters.cbegin(); it != m_counters.cend(); ++it) {
+        text += QStringLiteral("# TYPE %1%2 counter\n").arg(METRICS_PREFIX, it.key());
+        for (auto seat = it->cbegin(); seat != it->cend(); ++seat) {
+            text += QStringLiteral("%1 %2\n").arg(seriesName(it.key(), seat.key())).arg(seat.value());
+        }
+    }
+
+    for (auto it = m_histograms.cbegin(); it != m_histograms.cend(); ++it) {
+        text += QStringLiteral("# TYPE %1%2 histogram\n").arg(METRICS_PREFIX, it.key());
+        for (auto seat = it->cbegin(); seat != it->cend(); ++seat) {
+            for (const auto &[series, value] : histogramSamples(it.key(), seat.key(), seat.value())) {
+                text += QStringLiteral("%1 %2\n").arg(series).arg(value);
+            }
+        }
+    }
+
+    return text;
+}
+
+QList<std::pair<QString, double>> Metrics::histogramSamples(const QString &name, const QString &seat, const Histogram &histogram)
+{
+    QList<std::pair<QString, double>> samples;
+
+    // Prometheus buckets are cumulative
+    quint64 cumulative = 0;
+    for (size_t i = 0; i < histogram.buckets.size(); ++i) {
+        cumulative += histogram.buckets[i];
+        const QString bound = i < s_bucketBounds.size() ? QString::number(s_bucketBounds[i] / 1000.0) : QStringLiteral("+Inf");
+        samples.append({seriesName(name + QLatin1String("_bucket"), seat, QStringLiteral("le=\"%1\"").arg(bound)), double(cumulative)});
+    }
+    samples.append({seriesName(name + QLatin1String("_sum"), seat), histogram.sum / 1000.0});
+    samples.append({seriesName(name + QLatin1String("_count"), seat), double(histogram.count)});
+
+    return samples;
+}
+
+void Metrics::scheduleWrite()
+{
+    if (m_writeTimer->isActive()) {
+        return;
+    }
+    {
+        QMutexLocker locker(&PlasmaLogin::configLock());
+        if (PlasmaLogin::config()->metricsFile().isEmpty()) {
+            return;
+        }
+    }
+    m_writeTimer->start();
+}
+
+void Metrics::writeTextFile()
+{
+    QString path;
+    {
+        QMutexLocker locker(&PlasmaLogin::configLock());
+        path = PlasmaLogin::config()->metricsFile();
+    }
+    if (path.isEmpty()) {
+        return;
+    }
+
+    // written atomically, so a textfile collector never sees a partial file
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write metrics to" << path << file.errorString();
+        return;
+    }
+    file.write(ExportPrometheus().toUtf8());
+    if (!file.commit()) {
+        qWarning() << "Failed to write metrics to" << path << file.errorString();
+    }
+}
+}
+
+#include "moc_Metrics.cpp"
@@ -0,0 +1,90 @@
+/***************************************************************************
+ * SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ ***************************************************************************/
+
+#ifndef PLASMALOGIN_METRICS_H
+#define PLASMALOGIN_METRICS_H
+
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QVariantMap>
+
+#include <array>
+#include <utility>
+
+class QTimer;
+
+namespace PLASMALOGIN
+{
+/***************************************************************************
+ * org.kde.PlasmaLogin.Metrics
+ *
+ * Operational counters and duration histograms of the daemon. Series are
+ * labelled by seat where that makes sense and are kept in memory only.
+ * Recording may happen from any seat thread, it is forwarded to the
+ * thread of the Metrics object.
+ **************************************************************************/
+class Metrics : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(Metrics)
+public:
+    explicit Metrics(QObject *parent = nullptr);
+
+    /**
+     * Adds one to the counter @p name, e.g. "login_attempts_total"
+     */
+    void increment(const QString &name, const QString &seat = QString());
+
+    /**
+     * Records a duration for the histogram @p name, e.g. "vt_switch_seconds".
+     * Durations are taken in milliseconds and exported in seconds.
+     */
+    void observe(const QString &name, qint64 msecs, const QString &seat = QString());
+
+    /**
+     * Records a duration reported by Auth::phaseFinished
+     */
+    void observeHelperPhase(const QString &phase, qint64 msecs, const QString &seat, bool greeter);
+
+public slots:
+    QVariantMap GetMetrics() const;
+    QString ExportPrometheus() const;
+
+private:
+    // upper bounds in milliseconds (exported in seconds), the implicit last bucket is +Inf
+    static constexpr std::array<qint64, 9> s_bucketBounds{10, 50, 100, 250, 500, 1000, 2500, 5000, 10000};
+
+    struct Histogram {
+        std::array<quint64, s_bucketBounds.size() + 1> buckets{};
+        quint64 count{0};
+        quint64 sum{0}; // milliseconds
+    };
+
+    static QList<std::pair<QString, double>> histogramSamples(const QString &name, const QString &seat, const Histogram &histogram);
+
+    void scheduleWrite();
+    void writeTextFile();
+
+    // metric name -> seat -> value
+    QMap<QString, QMap<QString, quint64>> m_counters;
+    QMap<QString, QMap<QString, Histogram>> m_histograms;
+
+    QTimer *m_writeTimer{nullptr};
+};
+}
+
+#endif // PLASMALOGIN_METRICS_H
@@ -19,10 +19,12 @@
 
 #include "DaemonApp.h"
 #include "MainConfigLoader.h"
+#include "Metrics.h"
 #include "VirtualTerminal.h"
 
 #include <QDebug>
 #include <QFile>
+#include <QMutexLocker>
 #include <QTimer>
 
 #include "Constants.h"
@@ -37,6 +39,7 @@
 #include <Login1Session.h>
 #include <functional>
 #include <optional>
+#include <pwd.h>
 #include <unistd.h>
 
 namespace PLASMALOGIN
@@ -44,8 +47,8 @@ namespace PLASMALOGIN
 Seat::Seat(const QString &name, QObject *parent)
     : QObject(parent)
     , m_name(name)
+    , m_authSocketServer(Auth::createSocketServer(this))
 {
-    createDisplay();
 }
 
 const QString &Seat::name() const
@@ -53,61 +56,132 @@ const QString &Seat::name() const
     return m_name;
 }
 
-bool Seat::isTtyInUse(const QString &tty) const
+Auth::SocketServer *Seat::authSocketServer() const
 {
+    return m_authSocketServer;
+}
+
+QSet<QString> Seat::ttysInUse() const
+{
+    QSet<QString> ttys;
     if (!Logind::isAvailable()) {
-        return false;
+        return ttys;
     }
 
+    // One ListSessions round trip for all the candidates. Sessions without a
+    // seat (e.g. ssh) can't be holding a VT, so don't query their properties.
     OrgFreedesktopLogin1ManagerInterface manager(Logind::serviceName(), Logind::managerPath(), QDBusConnection::systemBus());
     auto reply = manager.ListSessions();
     reply.waitForFinished();
 
     const auto info = reply.value();
     for (const SessionInfo &sessionInfo : info) {
+        if (sessionInfo.seatId.isEmpty()) {
+            continue;
+        }
         OrgFreedesktopLogin1SessionInterface session(Logind::serviceName(), sessionInfo.sessionPath.path(), QDBusConnection::systemBus());
-        if (tty == session.tTY() && session.state() != QLatin1String("closing")) {
-            qDebug() << "tty" << tty << "already in use by" << session.user().path.path() << session.state() << session.display() << session.desktop()
-                     << session.vTNr();
-            return true;
+        const QString tty = session.tTY();
+        if (!tty.isEmpty() && session.state() != QLatin1String("closing")) {
+            // only what ListSessions already returned, more properties would be more round trips
+            qDebug() << "tty" << tty << "in use by session" << sessionInfo.sessionId << "of" << sessionInfo.userName;
+            ttys.insert(tty);
         }
     }
 
-    return false;
+    return ttys;
 }
 
 VirtualTerminal::Terminal Seat::availableVt() const
 {
-    if (!isTtyInUse(QStringLiteral("tty%1").arg(PLASMALOGIN_INITIAL_VT))) {
+    const QSet<QString> inUse = ttysInUse();
+    if (!inUse.contains(QStringLiteral("tty%1").arg(PLASMALOGIN_INITIAL_VT))) {
         return VirtualTerminal::openVt(PLASMALOGIN_INITIAL_VT);
     }
 
     const auto vt = VirtualTerminal::currentVt();
-    if (vt > 0 && !isTtyInUse(QStringLiteral("tty%1").arg(vt))) {
+    if (vt > 0 && !inUse.contains(QStringLiteral("tty%1").arg(vt))) {
         return VirtualTerminal::openVt(vt);
     }
 
     return VirtualTerminal::setUpNewVt();
 }
 
+static QDBusPendingCall getLogindProperty(const QString &path, const QString &interface, const QString &property)
+{
+    QDBusMessage msg = QDBusMessage::createMethodCall(Logind::serviceName(), path, QStringLiteral("org.freedesktop.DBus.Properties"), QStringLiteral("Get"));
+    msg << interface << property;
+    return QDBusConnection::systemBus().asyncCall(msg);
+}
+
 QString Seat::reusableSessionId(const QString &user) const
 {
+    // Only the sessions of that user are looked at: logind indexes them by uid
+    struct passwd pwd;
+    struct passwd *pw = nullptr;
+    char buffer[4096];
+    if (getpwnam_r(qPrintable(user), &pwd, buffer, sizeof(buffer), &pw) != 0 || !pw) {
+        return {};
+    }
+
     OrgFreedesktopLogin1ManagerInterface manager(Logind::serviceName(), Logind::managerPath(), QDBusConnection::systemBus());
-    auto reply = manager.ListSessions();
-    reply.waitForFinished();
+    auto userPath = manager.GetUser(pw->pw_uid);
+    userPath.waitForFinished();
+    if (userPath.isError()) {
+        // the user has no sessions at all
+        m_sessionServices.remove(pw->pw_uid);
+        return {};
+    }
 
-    for (const SessionInfo &sessionInfo : reply.value()) {
-        if (sessionInfo.userName != user) {
-            continue;
+    QDBusPendingReply<QDBusVariant> sessionsReply = getLogindProperty(userPath.value().path(), Logind::userIfaceName(), QStringLiteral("Sessions"));
+    sessionsReply.waitForFinished();
+    NamedSessionPathList sessions;
+    if (sessionsReply.isValid()) {
+        sessions = qdbus_cast<NamedSessionPathList>(sessionsReply.value().variant());
+    }
+
+    // The service of a session never changes, only ask for it once. The
+    // remaining properties are fetched in parallel.
+    struct Candidate {
+        QString id;
+        QDBusPendingReply<QDBusVariant> service; // only when not known yet
+        QDBusPendingReply<QDBusVariant> state;
+    };
+    const QHash<QString, QString> knownServices = m_sessionServices.take(pw->pw_uid);
+    QHash<QString, QString> &services = m_sessionServices[pw->pw_uid];
+    QList<Candidate> candidates;
+    for (const NamedSessionPath &session : std::as_const(sessions)) {
+        Candidate candidate{session.name, {}, {}};
+        const auto known = knownServices.constFind(session.name);
+        if (known == knownServices.cend()) {
+            candidate.service = getLogindProperty(session.path.path(), Logind::sessionIfaceName(), QStringLiteral("Service"));
+        } else {
+            services.insert(session.name, *known);
+            if (*known != QLatin1String("plasmalogin")) {
+                continue;
+            }
         }
+        candidate.state = getLogindProperty(session.path.path(), Logind::sessionIfaceName(), QStringLiteral("State"));
+        candidates.append(candidate);
+    }
 
-        OrgFreedesktopLogin1SessionInterface session(Logind::serviceName(), sessionInfo.sessionPath.path(), QDBusConnection::systemBus());
-        if (session.service() == QLatin1String("plasmalogin") && session.state() == QLatin1String("online")) {
-            return sessionInfo.sessionId;
+    QString sessionId;
+    for (Candidate &candidate : candidates) {
+        if (!services.contains(candidate.id)) {
+            candidate.service.waitForFinished();
+            if (candidate.service.isError()) {
+                continue;
+            }
+            services.insert(candidate.id, candidate.service.value().variant().toString());
+        }
+
+        candidate.state.waitForFinished();
+        if (sessionId.isEmpty() && services.value(candidate.id) == QLatin1String("plasmalogin") && !candidate.state.isError()
+            && candidate.state.value().variant().toString() == QLatin1String("online")) {
+            sessionId = candidate.id;
         }
     }
 
-    return {};
+    return sessionId;
 }
 
 void Seat::activateSession(const QString &sessionId) const
@@ -137,10 +211,8 @@ std::optional<int> Seat::vtForSession(const QString &sessionId) const
     return QStringView(session.tTY()).mid(3).toInt(); // we need to convert ttyN to N
 }
 
-void Seat::createDisplay()
+Display *Seat::addDisplay()
 {
-    PlasmaLogin::config()->load();
-
     // create a new display
     qDebug() << "Adding new display...";
     Display *display = new Display(this);
@@ -148,42 +220,111 @@ void Seat::createDisplay()
     // restart display on stop
     connect(display, &Display::stopped, this, &Seat::displayStopped);
 
+    // keep a greeter ready for when the new session ends
+    connect(display, &Display::greeterHandedOver, this, &Seat::createStandbyDisplay);
+
+    connect(display, &Display::greeterStarted, this, &Seat::greeterStarted);
+
     // add display to the list
     m_displays << display;
 
+    return display;
+}
+
+void Seat::createDisplay()
+{
+    const bool firstDisplay = tryLockFirstLogin();
+
     // Per-seat autologin overrides the global [Autologin] keys for a dedicated seat.
     // Resolve it here, after the configuration has been reloaded, rather than caching it
     // in Display's constructor.
+    bool seatGroup = false;
+    bool relogin = false;
     QString autologinUser;
     QString autologinSession;
-    const bool firstLogin = tryLockFirstLogin();
-    const KConfigGroup autologinGroup = PlasmaLogin::config()->config()->group(QStringLiteral("Autologin"));
-    if (autologinGroup.hasGroup(m_name)) {
-        const KConfigGroup seatGroup = autologinGroup.group(m_name);
-        if (seatGroup.readEntry("Relogin", PlasmaLogin::config()->autologinRelogin()) || firstLogin) {
-            autologinUser = seatGroup.readEntry("User", QString());
-            autologinSession = seatGroup.readEntry("Session", QString());
-            if (autologinUser.isEmpty()) {
+    {
+        QMutexLocker locker(&PlasmaLogin::configLock());
+        PlasmaLogin::config()->load();
+        relogin = PlasmaLogin::config()->autologinRelogin();
+        autologinUser = PlasmaLogin::config()->autologinUser();
+        autologinSession = PlasmaLogin::config()->autologinSession();
+
+        const KConfigGroup autologinGroup = PlasmaLogin::config()->config()->group(QStringLiteral("Autologin"));
+        if (autologinGroup.hasGroup(m_name)) {
+            const KConfigGroup group = autologinGroup.group(m_name);
+            seatGroup = true;
+            relogin = group.readEntry("Relogin", relogin);
+            autologinUser = group.readEntry("User", QString());
+            autologinSession = group.readEntry("Session", QString());
+        }
+    }
+
+    // Only ask the daemon about the first boot when it decides about autologin,
+    // the answer has been requested in the background since start-up.
+    if (!relogin && !autologinUser.isEmpty() && !(firstDisplay && daemonApp->isFirstBoot())) {
+        if (seatGroup) {
+            qDebug() << "Per-seat autologin: seat" << m_name << "has a config subgroup but Relogin is off and this is not the first login; it will be greeted.";
+        }
+        autologinUser.clear();
+        autologinSession.clear();
+    } else if (seatGroup) {
+        if (autologinUser.isEmpty()) {
+            // a subgroup without Relogin only asks for autologin on the first login
+            if (relogin || firstDisplay) {
                 qWarning() << "Per-seat autologin: seat" << m_name << "is configured to autologin but names no User; it will be greeted.";
-            } else {
-                qInfo() << "Per-seat autologin: seat" << m_name << "configured for user" << autologinUser << "session" << autologinSession;
             }
         } else {
-            qDebug() << "Per-seat autologin: seat" << m_name << "has a config subgroup but Relogin is off and this is not the first login; it will be greeted.";
+            qInfo() << "Per-seat autologin: seat" << m_name << "configured for user" << autologinUser << "session" << autologinSession;
         }
-    } else if (PlasmaLogin::config()->autologinRelogin() || firstLogin) {
-        autologinUser = PlasmaLogin::config()->autologinUser();
-        autologinSession = PlasmaLogin::config()->autologinSession();
     }
+
+    Display *display = addDisplay();
     display->setAutoLogin(autologinUser, autologinSession);
 
     // start the display
     display->start();
 }
 
+void Seat::createStandbyDisplay()
+{
+    Display *display = qobject_cast<Display *>(sender());
+    if (display && display == m_standbyDisplay) {
+        // the standby greeter was activated directly, e.g. through SwitchToGreeter
+        m_standbyDisplay = nullptr;
+    }
+
+    if (m_standbyDisplay || !canTTY()) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&PlasmaLogin::configLock());
+        PlasmaLogin::config()->load();
+        if (!PlasmaLogin::config()->greeterPrewarm()) {
+            return;
+        }
+    }
+
+    qDebug() << "Pre-warming standby greeter on seat" << m_name;
+    m_standbyDisplay = addDisplay();
+    m_standbyDisplay->setStandby(true);
+    m_standbyDisplay->start();
+}
+
 void Seat::displayStopped()
 {
     Display *display = qobject_cast<Display *>(sender());
+
+    if (display == m_standbyDisplay) {
+        // the standby greeter went away before it was needed, it will be
+        // recreated with the next session
+        qWarning() << "Standby greeter on seat" << m_name << "stopped";
+        m_standbyDisplay = nullptr;
+        m_displays.removeAll(display);
+        display->deleteLater();
+        return;
+    }
+
     std::optional<int> nextVt;
     nextVt = vtForSession(display->reuseSessionId());
 
@@ -192,10 +333,25 @@ void Seat::displayStopped()
     // delete display
     display->deleteLater();
 
+    // measure how long it takes to get back to a greeter after a logout
+    if (display->hasSession() && (m_displays.isEmpty() || (!nextVt && m_standbyDisplay))) {
+        m_logoutTimer.start();
+    }
+
+    bool promotedStandby = false;
+
     // restart otherwise
     if (m_displays.isEmpty()) {
         createDisplay();
     }
+    // A pre-warmed greeter is already running in the background, just switch to it
+    else if (!nextVt && m_standbyDisplay) {
+        nextVt = m_standbyDisplay->terminalId();
+        // later greeter starts of this display, e.g. restarts, are in the foreground
+        m_standbyDisplay->setStandby(false);
+        m_standbyDisplay = nullptr;
+        promotedStandby = true;
+    }
     // If there is still a session running on some display,
     // switch to last display in display vector.
     // Set vt_auto to true, so let the kernel handle the
@@ -208,11 +364,38 @@ void Seat::displayStopped()
     }
 
     if (nextVt) {
+        QElapsedTimer vtSwitchTimer;
+        vtSwitchTimer.start();
         VirtualTerminal::jumpToVt(*nextVt, true);
+        daemonApp->metrics()->observe(QStringLiteral("vt_switch_seconds"), vtSwitchTimer.elapsed(), m_name);
+    }
+
+    if (promotedStandby) {
+        greeterStarted();
     }
 }
 
+void Seat::greeterStarted()
+{
+    if (!m_logoutTimer.isValid()) {
+        return;
+    }
+
+    daemonApp->metrics()->observe(QStringLiteral("logout_to_greeter_seconds"), m_logoutTimer.elapsed(), m_name);
+    m_logoutTimer.invalidate();
+}
+
 bool Seat::canTTY()
+{
+    // CanTTY is fixed for the lifetime of a seat, don't ask logind again
+    // every time a greeter is (re)started
+    if (!m_canTTY) {
+        m_canTTY = queryCanTTY();
+    }
+    return *m_canTTY;
+}
+
+bool Seat::queryCanTTY() const
 {
     OrgFreedesktopLogin1ManagerInterface manager(Logind::serviceName(), Logind::managerPath(), QDBusConnection::systemBus());
     if (manager.isValid()) {
@@ -230,12 +413,12 @@ bool Seat::tryLockFirstLogin()
 {
     // One first-login token per seat, so each seat independently gets its
     // first-boot login; the machine-global soft-reboot check stays on the
-    // daemon (isFirstBoot).
+    // daemon (isFirstBoot) and is left to the caller.
     if (m_firstLoginLock) {
         return false;
     }
     m_firstLoginLock = true;
-    return daemonApp->isFirstBoot();
+    return true;
 }
 }
 
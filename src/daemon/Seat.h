@@ -18,7 +18,9 @@
 #define PLASMALOGIN_SEAT_H
 
 #include "Display.h"
+#include <QElapsedTimer>
 #include <QObject>
+#include <QSet>
 #include <QVector>
 #include <optional>
 
@@ -41,18 +43,33 @@ public:
     QString reusableSessionId(const QString &user) const;
     void activateSession(const QString &sessionId) const;
     std::optional<int> vtForSession(const QString &sessionId) const;
+    // the helpers of this seat's Auth objects connect back to it
+    Auth::SocketServer *authSocketServer() const;
 
 private slots:
     void displayStopped();
+    void greeterStarted();
+    void createStandbyDisplay();
 
 private:
-    bool isTtyInUse(const QString &tty) const;
+    Display *addDisplay();
+    QSet<QString> ttysInUse() const;
+    bool queryCanTTY() const;
 
     QString m_name;
+    Auth::SocketServer *m_authSocketServer{nullptr};
 
     bool m_firstLoginLock = false;
+    std::optional<bool> m_canTTY;
+    // uid -> session id -> logind service of the session, refreshed by reusableSessionId()
+    mutable QHash<uint, QHash<QString, QString>> m_sessionServices;
 
     QVector<Display *> m_displays;
+    // pre-warmed greeter waiting in the background, also part of m_displays
+    Display *m_standbyDisplay{nullptr};
+
+    // running from the end of a user session until the next greeter is up
+    QElapsedTimer m_logoutTimer;
 };
 }
 
@@ -23,6 +23,7 @@
 #include <QDBusContext>
 #include <QDBusMessage>
 #include <QDBusPendingReply>
+#include <QThread>
 
 #include "LogindDBusTypes.h"
 #include <Login1Manager.h>
@@ -127,13 +128,38 @@ void SeatManager::initialize()
     connect(logind, &OrgFreedesktopLogin1ManagerInterface::SecureAttentionKey, this, &SeatManager::logindSecureAttentionKey);
 }
 
+SeatManager::~SeatManager()
+{
+    // the seats are deleted when their thread finishes
+    for (QThread *thread : std::as_const(m_threads)) {
+        thread->quit();
+        thread->wait();
+    }
+}
+
 void SeatManager::createSeat(const QString &name)
 {
+    if (m_seats.contains(name)) {
+        return;
+    }
+
+    // every seat gets its own thread, the seat is deleted on it
+    QThread *thread = new QThread(this);
+    thread->setObjectName(name);
+
     // create a seat
-    Seat *seat = new Seat(name, this);
+    Seat *seat = new Seat(name);
+    seat->moveToThread(thread);
+    connect(thread, &QThread::finished, seat, &QObject::deleteLater);
+    thread->start();
 
     // add to the list
     m_seats.insert(name, seat);
+    m_threads.insert(name, thread);
+
+    QMetaObject::invokeMethod(seat, [seat] {
+        seat->createDisplay();
+    });
 
     // emit signal
     emit seatCreated(name);
@@ -148,8 +174,11 @@ void SeatManager::removeSeat(const QString &name)
 
     // remove from the list
     Seat *seat = m_seats.take(name);
+    QThread *thread = m_threads.take(name);
 
-    // delete seat
+    // delete the seat on its thread, then the thread once it has stopped
+    connect(seat, &QObject::destroyed, thread, &QThread::quit);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
     seat->deleteLater();
 
     // emit signal
@@ -182,7 +211,10 @@ void SeatManager::switchToGreeter(const QString &name)
     }
 
     // switch to greeter
-    m_seats.value(name)->createDisplay();
+    Seat *seat = m_seats.value(name);
+    QMetaObject::invokeMethod(seat, [seat] {
+        seat->createDisplay();
+    });
 }
 
 void PLASMALOGIN::SeatManager::logindSecureAttentionKey(const QString &name, const QDBusObjectPath &objectPath)
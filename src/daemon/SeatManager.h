@@ -21,11 +21,21 @@
 #include <QHash>
 #include <QObject>
 
+class QThread;
+
 namespace PLASMALOGIN
 {
 class Seat;
 class LogindSeat;
 
+/**
+ * Tracks the logind seats and runs a Seat for each graphical one.
+ *
+ * Every Seat lives on its own thread, so a slow PAM conversation, helper
+ * spawn or logind call on one seat doesn't hold up the others. The
+ * SeatManager itself and its bookkeeping stay on the main thread, seats
+ * are only ever reached through queued invocations.
+ */
 class SeatManager : public QObject
 {
     Q_OBJECT
@@ -34,6 +44,7 @@ public:
         : QObject(parent)
     {
     }
+    ~SeatManager() override;
 
     void initialize();
     void createSeat(const QString &name);
@@ -51,6 +62,7 @@ private Q_SLOTS:
 
 private:
     QHash<QString, Seat *> m_seats; // these will exist only for graphical seats
+    QHash<QString, QThread *> m_threads; // the thread each of m_seats runs on
     QHash<QString, LogindSeat *> m_systemSeats; // these will exist for all seats
 };
 }
@@ -162,6 +162,16 @@ void SocketServer::loginSucceeded(QLocalSocket *socket)
     SocketWriter(socket) << quint32(DaemonMessages::LoginSucceeded);
 }
 
+void SocketServer::loginBusy(QLocalSocket *socket)
+{
+    SocketWriter(socket) << quint32(DaemonMessages::LoginBusy);
+}
+
+void SocketServer::loginCancelled(QLocalSocket *socket)
+{
+    SocketWriter(socket) << quint32(DaemonMessages::LoginCancelled);
+}
+
 void SocketServer::informationMessage(QLocalSocket *socket, const QString &message)
 {
     SocketWriter(socket) << quint32(DaemonMessages::InformationMessage) << message;
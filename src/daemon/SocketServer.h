@@ -48,6 +48,8 @@ public slots:
     void informationMessage(QLocalSocket *socket, const QString &message);
     void loginFailed(QLocalSocket *socket);
     void loginSucceeded(QLocalSocket *socket);
+    void loginBusy(QLocalSocket *socket);
+    void loginCancelled(QLocalSocket *socket);
 
 signals:
     void login(QLocalSocket *socket, const QString &user, const QString &password, const Session &session);
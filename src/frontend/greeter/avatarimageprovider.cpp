@@ -0,0 +1,137 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <QUrl>
+
+#include "avatarimageprovider.h"
+
+static QString cacheDir()
+{
+    static const QString dir = [] {
+        const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/avatars");
+        return QDir().mkpath(dir) ? dir : QString();
+    }();
+    return dir;
+}
+
+// Cached thumbnails are named "<sha1 of the path>-<modification time>-<size>.png",
+// this returns the part up to the size
+static QString cacheKey(const QString &path)
+{
+    const QFileInfo info(path);
+    const qint64 modified = info.lastModified().isValid() ? info.lastModified().toSecsSinceEpoch() : 0;
+    const QByteArray pathHash = QCryptographicHash::hash(path.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QString::fromLatin1(pathHash) + QLatin1Char('-') + QString::number(modified) + QLatin1Char('-');
+}
+
+class AvatarImageResponse : public QQuickImageResponse, public QRunnable
+{
+public:
+    AvatarImageResponse(const QString &path, const QSize &requestedSize)
+        : m_path(path)
+        , m_requestedSize(requestedSize)
+    {
+        setAutoDelete(false);
+    }
+
+    QQuickTextureFactory *textureFactory() const override
+    {
+        return QQuickTextureFactory::textureFactoryForImage(m_image);
+    }
+
+    QString errorString() const override
+    {
+        return m_errorString;
+    }
+
+    void run() override
+    {
+        const QString cachePath = cacheFilePath();
+        if (!cachePath.isEmpty() && m_image.load(cachePath, "PNG")) {
+            Q_EMIT finished();
+            return;
+        }
+
+        QImageReader reader(m_path);
+        // Only ever scale down, covering the requested size as the delegates crop to a circle
+        const QSize size = reader.size();
+        if (size.isValid() && m_requestedSize.isValid() && (size.width() > m_requestedSize.width() || size.height() > m_requestedSize.height())) {
+            reader.setScaledSize(size.scaled(m_requestedSize, Qt::KeepAspectRatioByExpanding));
+        }
+
+        if (!reader.read(&m_image)) {
+            m_errorString = reader.errorString();
+            qWarning() << "Failed to load avatar" << m_path << m_errorString;
+            Q_EMIT finished();
+            return;
+        }
+
+        if (!cachePath.isEmpty()) {
+            QSaveFile file(cachePath);
+            if (!file.open(QIODevice::WriteOnly) || !m_image.save(&file, "PNG") || !file.commit()) {
+                qWarning() << "Failed to cache avatar" << m_path << "in" << cachePath;
+            }
+        }
+
+        Q_EMIT finished();
+    }
+
+private:
+    QString cacheFilePath() const
+    {
+        const QString dir = cacheDir();
+        if (dir.isEmpty()) {
+            return {};
+        }
+        return QStringLiteral("%1/%2%3x%4.png").arg(dir, cacheKey(m_path)).arg(m_requestedSize.width()).arg(m_requestedSize.height());
+    }
+
+    const QString m_path;
+    const QSize m_requestedSize;
+    QImage m_image;
+    QString m_errorString;
+};
+
+QQuickImageResponse *AvatarImageProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    auto response = new AvatarImageResponse(QUrl::fromPercentEncoding(id.toUtf8()), requestedSize);
+    QThreadPool::globalInstance()->start(response);
+    return response;
+}
+
+void AvatarImageProvider::pruneCache(const QStringList &facePaths)
+{
+    const QString dir = cacheDir();
+    if (dir.isEmpty()) {
+        return;
+    }
+
+    QSet<QString> keys;
+    for (const QString &path : facePaths) {
+        keys.insert(cacheKey(path));
+    }
+
+    // the key ends at the first '-' after the 40 digits of the path hash
+    const QStringList entries = QDir(dir).entryList({QStringLiteral("*.png")}, QDir::Files);
+    for (const QString &entry : entries) {
+        const qsizetype end = entry.indexOf(QLatin1Char('-'), 41);
+        if (end < 0 || !keys.contains(entry.left(end + 1))) {
+            QFile::remove(dir + QLatin1Char('/') + entry);
+        }
+    }
+}
@@ -0,0 +1,28 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QQuickAsyncImageProvider>
+
+/**
+ * Serves the user faces as "image://avatar/<percent encoded path>".
+ *
+ * Faces are decoded and scaled to the requested size on the global thread
+ * pool, and the thumbnails are cached on disk keyed by path, modification
+ * time and size, so large avatars aren't decoded on every start.
+ */
+class AvatarImageProvider : public QQuickAsyncImageProvider
+{
+public:
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+
+    /**
+     * Removes the thumbnails of faces that aren't in @p facePaths anymore,
+     * or that have been changed since they were cached
+     */
+    static void pruneCache(const QStringList &facePaths);
+};
@@ -108,6 +108,17 @@ void GreeterProxy::readyRead()
             // emit signal
             emit loginFailed();
         } break;
+        case DaemonMessages::LoginBusy: {
+            // log message
+            qDebug() << "Message received from daemon: LoginBusy";
+
+            // emit signal
+            emit loginBusy();
+        } break;
+        case DaemonMessages::LoginCancelled: {
+            // the answer to the newer login follows
+            qDebug() << "Message received from daemon: LoginCancelled";
+        } break;
         case DaemonMessages::InformationMessage: {
             QString message;
             input >> message;
@@ -54,6 +54,7 @@ signals:
     void socketDisconnected();
     void loginFailed();
     void loginSucceeded();
+    void loginBusy();
 
 private:
     GreeterProxyPrivate *d{nullptr};
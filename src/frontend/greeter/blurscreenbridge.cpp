@@ -7,8 +7,10 @@
 #include <QDBusConnection>
 #include <QDBusMessage>
 #include <QDBusServiceWatcher>
+#include <QGuiApplication>
 
 #include "blurscreenbridge.h"
+#include "wallpapermanager.h"
 
 BlurScreenBridge::BlurScreenBridge(QObject *parent)
     : QObject(parent)
@@ -16,7 +18,16 @@ BlurScreenBridge::BlurScreenBridge(QObject *parent)
     QDBusServiceWatcher *watcher =
         new QDBusServiceWatcher(QStringLiteral("org.kde.plasma.wallpaper"), QDBusConnection::sessionBus(), QDBusServiceWatcher::WatchForRegistration, this);
     connect(watcher, &QDBusServiceWatcher::serviceRegistered, this, &BlurScreenBridge::notifyBlurScreenChange);
+    connect(watcher, &QDBusServiceWatcher::serviceRegistered, this, &BlurScreenBridge::notifyIdleStateChange);
     connect(this, &BlurScreenBridge::activeWindowChanged, this, &BlurScreenBridge::notifyBlurScreenChange);
+    connect(this, &BlurScreenBridge::activeWindowChanged, this, &BlurScreenBridge::notifyIdleStateChange);
+    connect(this, &BlurScreenBridge::screensOffChanged, this, &BlurScreenBridge::notifyIdleStateChange);
+}
+
+BlurScreenBridge *BlurScreenBridge::self()
+{
+    static BlurScreenBridge *bridge = new BlurScreenBridge(qApp);
+    return bridge;
 }
 
 void BlurScreenBridge::setActiveWindow(QQuickWindow *activeWindow)
@@ -26,6 +37,10 @@ void BlurScreenBridge::setActiveWindow(QQuickWindow *activeWindow)
     }
 
     m_activeWindow = activeWindow;
+    if (m_activeWindow && m_screensOff) {
+        m_screensOff = false;
+        Q_EMIT screensOffChanged();
+    }
     Q_EMIT activeWindowChanged();
 }
 
@@ -34,6 +49,28 @@ QQuickWindow *BlurScreenBridge::activeWindow() const
     return m_activeWindow;
 }
 
+bool BlurScreenBridge::screensOff() const
+{
+    return m_screensOff;
+}
+
+void BlurScreenBridge::setScreensOff()
+{
+    if (m_screensOff) {
+        return;
+    }
+
+    m_screensOff = true;
+    Q_EMIT screensOffChanged();
+}
+
+void BlurScreenBridge::setWallpaperManager(WallpaperManager *wallpaperManager)
+{
+    m_wallpaperManager = wallpaperManager;
+    notifyBlurScreenChange();
+    notifyIdleStateChange();
+}
+
 void BlurScreenBridge::notifyBlurScreenChange()
 {
     // Forward active window's screen to wallpaper over D-Bus for blur
@@ -45,6 +82,11 @@ void BlurScreenBridge::notifyBlurScreenChange()
         }
     }
 
+    if (m_wallpaperManager) {
+        m_wallpaperManager->blurScreen(screenName);
+        return;
+    }
+
     QDBusMessage msg = QDBusMessage::createMethodCall(QStringLiteral("org.kde.plasma.wallpaper"),
                                                       QStringLiteral("/Wallpaper"),
                                                       QStringLiteral("org.kde.plasma.wallpaper"),
@@ -53,3 +95,28 @@ void BlurScreenBridge::notifyBlurScreenChange()
 
     QDBusConnection::sessionBus().call(msg, QDBus::NoBlock);
 }
+
+void BlurScreenBridge::notifyIdleStateChange()
+{
+    QString state;
+    if (m_activeWindow) {
+        state = QStringLiteral("active");
+    } else if (m_screensOff) {
+        state = QStringLiteral("off");
+    } else {
+        state = QStringLiteral("idle");
+    }
+
+    if (m_wallpaperManager) {
+        m_wallpaperManager->setIdleState(state);
+        return;
+    }
+
+    QDBusMessage msg = QDBusMessage::createMethodCall(QStringLiteral("org.kde.plasma.wallpaper"),
+                                                      QStringLiteral("/Wallpaper"),
+                                                      QStringLiteral("org.kde.plasma.wallpaper"),
+                                                      QStringLiteral("setIdleState"));
+    msg << state;
+
+    QDBusConnection::sessionBus().call(msg, QDBus::NoBlock);
+}
@@ -8,23 +8,48 @@
 
 #include <QQuickWindow>
 
+class WallpaperManager;
+
 class BlurScreenBridge : public QObject
 {
     Q_OBJECT
     QML_ELEMENT
     Q_PROPERTY(QQuickWindow *activeWindow READ activeWindow WRITE setActiveWindow NOTIFY activeWindowChanged)
+    Q_PROPERTY(bool screensOff READ screensOff NOTIFY screensOffChanged)
 
 public:
     explicit BlurScreenBridge(QObject *parent = nullptr);
+    static BlurScreenBridge *self();
 
     void setActiveWindow(QQuickWindow *activeWindow);
 
     QQuickWindow *activeWindow() const;
 
+    /**
+     * True from turning the screens off until a window is activated again.
+     * The wallpaper is told the resulting idle state: "active" with an
+     * active window, "idle" without one and "off" with the screens off.
+     */
+    bool screensOff() const;
+    Q_INVOKABLE void setScreensOff();
+
+    /**
+     * In single-process mode the wallpaper is driven directly instead of over D-Bus
+     */
+    void setWallpaperManager(WallpaperManager *wallpaperManager);
+
+    /**
+     * Tells the wallpaper the screen of the active window again, e.g. after it moved
+     */
+    void notifyBlurScreenChange();
+
 Q_SIGNALS:
     void activeWindowChanged();
+    void screensOffChanged();
 
 private:
-    void notifyBlurScreenChange();
+    void notifyIdleStateChange();
     QPointer<QQuickWindow> m_activeWindow = nullptr;
+    bool m_screensOff = false;
+    QPointer<WallpaperManager> m_wallpaperManager;
 };
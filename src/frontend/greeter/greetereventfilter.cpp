@@ -7,10 +7,21 @@
 #include <KScreenDpms/Dpms>
 #include <kscreendpms/dpms.h>
 
+#include <QGuiApplication>
 #include <QKeyEvent>
 
 #include "greetereventfilter.h"
 
+// one for all windows, creating it queries the outputs
+static KScreen::Dpms *dpms()
+{
+    static QPointer<KScreen::Dpms> instance;
+    if (!instance) {
+        instance = new KScreen::Dpms(qApp);
+    }
+    return instance;
+}
+
 GreeterEventFilter::GreeterEventFilter(QObject *parent)
     : QObject(parent)
 {
@@ -49,16 +60,8 @@ bool GreeterEventFilter::eventFilter(QObject *obj, QEvent *event)
 
         if (keyEvent->key() == Qt::Key_Escape) {
             // Esc -> turn off screens
-            auto dpms = new KScreen::Dpms(this);
-            if (dpms->isSupported()) {
-                connect(dpms, &KScreen::Dpms::hasPendingChangesChanged, this, [dpms](bool hasPendingChanges) {
-                    if (!hasPendingChanges) {
-                        dpms->deleteLater();
-                    }
-                });
-                dpms->switchMode(KScreen::Dpms::Off);
-            } else {
-                dpms->deleteLater();
+            if (dpms()->isSupported()) {
+                dpms()->switchMode(KScreen::Dpms::Off);
             }
 
             Q_EMIT escapeKeyPressed();
@@ -7,11 +7,15 @@
 #include <QCommandLineOption>
 #include <QCommandLineParser>
 #include <QGuiApplication>
+#include <QHash>
 #include <QObject>
 #include <QQmlContext>
+#include <QQmlExtensionPlugin>
 #include <QQuickView>
 #include <QScreen>
 #include <QSurfaceFormat>
+#include <QThreadPool>
+#include <QTimer>
 
 #include <KLocalizedQmlContext>
 #include <KLocalizedString>
@@ -22,12 +26,29 @@
 #include "backend/GreeterProxy.h"
 #include "mockbackend/MockGreeterProxy.h"
 
+#include "avatarimageprovider.h"
 #include "blurscreenbridge.h"
 #include "greetereventfilter.h"
 #include "models/sessionmodel.h"
 #include "models/usermodel.h"
+#include "pipelinecache.h"
 #include "plasmaloginsettings.h"
 #include "stateconfig.h"
+#include "wallpapermanager.h"
+
+#include <signal.h>
+
+Q_IMPORT_QML_PLUGIN(org_kde_plasma_login_wallpaperPlugin)
+
+// The greeter is stopped with SIGTERM once the session starts. Leave the event
+// loop so LoginGreeter deletes its windows, which writes their pipeline cache.
+static void sigtermHandler(int signalNumber)
+{
+    Q_UNUSED(signalNumber)
+    if (QCoreApplication::instance()) {
+        QCoreApplication::instance()->quit();
+    }
+}
 
 class LoginGreeter : public QObject
 {
@@ -38,49 +59,137 @@ public:
         , m_engine(PlasmaQuick::globalEngine())
     {
         KLocalization::setupLocalizedContext(m_engine.get());
+        if (!m_engine->imageProvider(QStringLiteral("avatar"))) {
+            m_engine->addImageProvider(QStringLiteral("avatar"), new AvatarImageProvider);
+        }
 
-        connect(qApp, &QGuiApplication::screenAdded, this, [this](QScreen *screen) {
-            createWindowForScreen(screen);
+        // Show the wallpaper from this process, sharing the engine, instead of
+        // relying on plasma-login-wallpaper. Created first so the wallpaper
+        // windows end up below the greeter windows.
+        if (PlasmaLoginSettings::getInstance().singleProcess() && !s_testMode) {
+            BlurScreenBridge::self()->setWallpaperManager(new WallpaperManager(m_engine, this));
+        }
+
+        // Screens come and go in bursts when docking, so hotplug is handled once
+        // things settle. Windows of removed screens are kept around, hidden, to be
+        // moved to the next added screen instead of loading Main.qml again.
+        m_hotplugTimer.setSingleShot(true);
+        m_hotplugTimer.setInterval(250);
+        connect(&m_hotplugTimer, &QTimer::timeout, this, &LoginGreeter::syncScreens);
+
+        connect(qApp, &QGuiApplication::screenAdded, &m_hotplugTimer, qOverload<>(&QTimer::start));
+        connect(qApp, &QGuiApplication::screenRemoved, this, [this](QScreen *screen) {
+            parkWindowOfScreen(screen);
+            m_hotplugTimer.start();
         });
-        for (QScreen *screen : qApp->screens()) {
-            createWindowForScreen(screen);
+        // The lightweight profile only shows the login UI on the primary screen,
+        // the others just show the wallpaper
+        if (PlasmaLoginSettings::getInstance().lightweight()) {
+            connect(qApp, &QGuiApplication::primaryScreenChanged, &m_hotplugTimer, qOverload<>(&QTimer::start));
         }
+        syncScreens();
     }
     static void setTestModeEnabled(bool testModeEnabled);
     static bool testModeEnabled();
 
 private:
-    void createWindowForScreen(QScreen *screen)
+    void syncScreens()
     {
-        auto *window = new QQuickView(m_engine.get(), nullptr);
-        window->QObject::setParent(this);
-        window->setScreen(screen);
-        window->setColor(s_testMode ? Qt::darkGray : Qt::transparent);
+        QList<QScreen *> screens;
+        if (!PlasmaLoginSettings::getInstance().lightweight()) {
+            screens = qApp->screens();
+        } else if (QScreen *screen = qApp->primaryScreen()) {
+            screens = {screen};
+        }
 
-        connect(qApp, &QGuiApplication::screenRemoved, window, [window](QScreen *screenRemoved) {
-            if (screenRemoved == window->screen()) {
-                delete window;
+        const QList<QScreen *> windowScreens = m_windows.keys();
+        for (QScreen *screen : windowScreens) {
+            if (!screens.contains(screen)) {
+                parkWindowOfScreen(screen);
             }
-        });
+        }
 
-        window->setGeometry(screen->geometry());
+        for (QScreen *screen : std::as_const(screens)) {
+            if (m_windows.contains(screen)) {
+                continue;
+            }
+            QQuickView *window = m_parkedWindows.isEmpty() ? createWindow() : m_parkedWindows.takeLast();
+            showWindowOnScreen(window, screen);
+        }
+
+        while (m_parkedWindows.size() > s_maxParkedWindows) {
+            delete m_parkedWindows.takeFirst();
+        }
+
+        // the active window may have been moved to another screen
+        BlurScreenBridge::self()->notifyBlurScreenChange();
+    }
+
+    QQuickView *createWindow()
+    {
+        auto *window = new QQuickView(m_engine.get(), nullptr);
+        window->QObject::setParent(this);
+        window->setColor(s_testMode ? Qt::darkGray : Qt::transparent);
+        PipelineCache::setup(window, QStringLiteral("greeter"));
 
         if (auto layerShellWindow = LayerShellQt::Window::get(window)) {
             layerShellWindow->setScope(QStringLiteral("plasma-login-greeter"));
             layerShellWindow->setLayer(LayerShellQt::Window::LayerTop);
             layerShellWindow->setExclusiveZone(-1);
             layerShellWindow->setKeyboardInteractivity(LayerShellQt::Window::KeyboardInteractivityExclusive);
-            layerShellWindow->setScreen(screen);
         }
 
         window->setResizeMode(QQuickView::SizeRootObjectToView);
 
         window->setSource(QUrl("qrc:/qt/qml/org/kde/plasma/login/Main.qml"));
+        return window;
+    }
+
+    void showWindowOnScreen(QQuickView *window, QScreen *screen)
+    {
+        m_windows.insert(screen, window);
+
+        window->setScreen(screen);
+        window->setGeometry(screen->geometry());
+        if (auto layerShellWindow = LayerShellQt::Window::get(window)) {
+            layerShellWindow->setScreen(screen);
+        }
+
+        connect(screen, &QScreen::geometryChanged, window, [window, screen](const QRect &geometry) {
+            if (window->screen() == screen) {
+                window->setGeometry(geometry);
+            }
+        });
+
         window->show();
     }
 
+    void parkWindowOfScreen(QScreen *screen)
+    {
+        QQuickView *window = m_windows.take(screen);
+        if (!window) {
+            return;
+        }
+
+        // nobody can log in on a hidden window, the greeter is idle until another one is activated
+        if (BlurScreenBridge::self()->activeWindow() == window) {
+            if (auto greeterState = m_engine->singletonInstance<QObject *>("org.kde.plasma.login", "GreeterState")) {
+                QMetaObject::invokeMethod(greeterState, "timeoutWindow", QVariant::fromValue<QObject *>(window));
+            }
+            BlurScreenBridge::self()->setActiveWindow(nullptr);
+        }
+
+        window->hide();
+        m_parkedWindows.append(window);
+    }
+
     static bool s_testMode;
     std::shared_ptr<QQmlEngine> m_engine;
+
+    QTimer m_hotplugTimer;
+    QHash<QScreen *, QQuickView *> m_windows;
+    QList<QQuickView *> m_parkedWindows;
+    static constexpr int s_maxParkedWindows = 2;
 };
 
 bool LoginGreeter::s_testMode = false;
@@ -105,6 +214,7 @@ int main(int argc, char *argv[])
 
     QGuiApplication app(argc, argv);
     parser.process(app);
+    signal(SIGTERM, sigtermHandler);
     LoginGreeter::setTestModeEnabled(parser.isSet(QStringLiteral("test")));
 
     auto format = QSurfaceFormat::defaultFormat();
@@ -112,17 +222,49 @@ int main(int argc, char *argv[])
     QSurfaceFormat::setDefaultFormat(format);
 
     QQuickWindow::setDefaultAlphaBuffer(true);
+
+    // Enumerating users and sessions is slow, read them on worker threads while
+    // the windows are set up. The singletons are only created once QML uses them.
+    const QFuture<QList<User>> users = UserModel::loadUsers();
+    const QFuture<QList<Session>> sessions = SessionModel::loadSessions();
+
+    // drop the cached faces of removed users once they are known
+    users.then(QThreadPool::globalInstance(), [](const QList<User> &users) {
+        // the paths UserModel hands to the provider, and the fallback face of Main.qml
+        QStringList facePaths{QStringLiteral(":/qt/qml/org/kde/plasma/login/.face.icon")};
+        for (const User &user : users) {
+            const QUrl url(user.icon);
+            facePaths << (url.isLocalFile() ? url.toLocalFile() : QLatin1Char(':') + url.path());
+        }
+        AvatarImageProvider::pruneCache(facePaths);
+    });
+
     if (LoginGreeter::testModeEnabled()) {
-        qmlRegisterSingletonInstance("org.kde.plasma.login", 0, 1, "Authenticator", new MockGreeterProxy);
+        qmlRegisterSingletonType<MockGreeterProxy>("org.kde.plasma.login", 0, 1, "Authenticator", [](QQmlEngine *, QJSEngine *) -> QObject * {
+            return new MockGreeterProxy;
+        });
     } else {
-        qmlRegisterSingletonInstance("org.kde.plasma.login", 0, 1, "Authenticator", new PLASMALOGIN::GreeterProxy);
+        qmlRegisterSingletonType<PLASMALOGIN::GreeterProxy>("org.kde.plasma.login", 0, 1, "Authenticator", [](QQmlEngine *, QJSEngine *) -> QObject * {
+            return new PLASMALOGIN::GreeterProxy;
+        });
     }
-    qmlRegisterSingletonInstance("org.kde.plasma.login", 0, 1, "SessionModel", new SessionModel);
-    qmlRegisterSingletonInstance("org.kde.plasma.login", 0, 1, "UserModel", new UserModel);
-    qmlRegisterSingletonInstance("org.kde.plasma.login", 0, 1, "SessionManagement", new SessionManagement());
+    qmlRegisterSingletonType<SessionModel>("org.kde.plasma.login", 0, 1, "SessionModel", [sessions](QQmlEngine *, QJSEngine *) -> QObject * {
+        return new SessionModel(sessions);
+    });
+    qmlRegisterSingletonType<UserModel>("org.kde.plasma.login", 0, 1, "UserModel", [users](QQmlEngine *, QJSEngine *) -> QObject * {
+        auto userModel = new UserModel(users);
+        userModel->setIconProvider(QStringLiteral("avatar"));
+        return userModel;
+    });
+    qmlRegisterSingletonType<SessionManagement>("org.kde.plasma.login", 0, 1, "SessionManagement", [](QQmlEngine *, QJSEngine *) -> QObject * {
+        return new SessionManagement();
+    });
     qmlRegisterSingletonInstance("org.kde.plasma.login", 0, 1, "Settings", &PlasmaLoginSettings::getInstance());
     qmlRegisterSingletonInstance("org.kde.plasma.login", 0, 1, "StateConfig", StateConfig::self());
-    qmlRegisterSingletonInstance("org.kde.plasma.login", 0, 1, "BlurScreenBridge", new BlurScreenBridge);
+    qmlRegisterSingletonType<BlurScreenBridge>("org.kde.plasma.login", 0, 1, "BlurScreenBridge", [](QQmlEngine *, QJSEngine *) -> QObject * {
+        QQmlEngine::setObjectOwnership(BlurScreenBridge::self(), QQmlEngine::CppOwnership);
+        return BlurScreenBridge::self();
+    });
     qmlRegisterType<GreeterEventFilter>("org.kde.plasma.login", 0, 1, "GreeterEventFilter");
 
     LoginGreeter greeter;
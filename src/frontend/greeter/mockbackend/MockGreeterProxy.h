@@ -23,6 +23,7 @@ Q_SIGNALS:
     void socketDisconnected();
     void loginFailed();
     void loginSucceeded();
+    void loginBusy();
 
 private:
     static constexpr QLatin1String s_mockPassword = QLatin1String("mypassword");
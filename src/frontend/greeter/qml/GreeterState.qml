@@ -34,7 +34,7 @@ Item {
 
     // Shared state
 
-    readonly property int beyondUserLimit: PlasmaLogin.UserModel.rowCount() === 0 || PlasmaLogin.UserModel.rowCount() > 7
+    readonly property int beyondUserLimit: PlasmaLogin.UserModel.count === 0 || PlasmaLogin.UserModel.count > 7
 
     property int loginState: GreeterState.LoginState.UserList
 
@@ -48,6 +48,11 @@ Item {
     }
 
     property int sessionIndex: {
+        // the sessions are loaded asynchronously
+        if (PlasmaLogin.SessionModel.count === 0) {
+            return 0;
+        }
+
         // indexOfData will return -1 if passed an empty string, which these are by default
         let preselectedSessionIndex = PlasmaLogin.SessionModel.indexOfData(PlasmaLogin.Settings.preselectedSession, PlasmaLogin.SessionModel.FileNameRole);
         let lastLoggedInSessionIndex = PlasmaLogin.SessionModel.indexOfData(getLastLoggedInSessionForUser(PlasmaLogin.StateConfig.lastLoggedInUser), PlasmaLogin.SessionModel.FileNameRole);
@@ -62,6 +67,11 @@ Item {
     }
 
     property int userListIndex: {
+        // the users are loaded asynchronously
+        if (PlasmaLogin.UserModel.count === 0) {
+            return 0;
+        }
+
         // indexOfData will return -1 if passed an empty string, which these are by default
         let preselectedUserIndex = PlasmaLogin.UserModel.indexOfData(PlasmaLogin.Settings.preselectedUser, PlasmaLogin.UserModel.NameRole);
         let lastLoggedInUserIndex = PlasmaLogin.UserModel.indexOfData(PlasmaLogin.StateConfig.lastLoggedInUser, PlasmaLogin.UserModel.NameRole);
@@ -185,12 +195,15 @@ Item {
             }
         }
 
-        for (let user in result) {
-            if (PlasmaLogin.UserModel.indexOfData(user, PlasmaLogin.UserModel.NameRole) === -1) {
-                delete result[user];
+        // the users are loaded asynchronously, only forget removed ones once they are known
+        if (PlasmaLogin.UserModel.count > 0) {
+            for (let user in result) {
+                if (PlasmaLogin.UserModel.indexOfData(user, PlasmaLogin.UserModel.NameRole) === -1) {
+                    delete result[user];
+                }
             }
         }
-        
+
         return result;
     }
 
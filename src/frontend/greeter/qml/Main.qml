@@ -23,7 +23,7 @@ Item {
 
     // If we're using software rendering, draw outlines instead of shadows
     // See https://bugs.kde.org/show_bug.cgi?id=398317
-    readonly property bool softwareRendering: GraphicsInfo.api === GraphicsInfo.Software
+    readonly property bool softwareRendering: GraphicsInfo.api === GraphicsInfo.Software || PlasmaLogin.Settings.lightweight
 
     Kirigami.Theme.colorSet: Kirigami.Theme.Complementary
     Kirigami.Theme.inherit: false
@@ -33,6 +33,16 @@ Item {
     LayoutMirroring.enabled: Qt.application.layoutDirection === Qt.RightToLeft
     LayoutMirroring.childrenInherit: true
 
+    // every animation of the greeter is timed by these
+    Component.onCompleted: {
+        if (PlasmaLogin.Settings.lightweight) {
+            Kirigami.Units.veryShortDuration = 0;
+            Kirigami.Units.shortDuration = 0;
+            Kirigami.Units.longDuration = 0;
+            Kirigami.Units.veryLongDuration = 0;
+        }
+    }
+
     KeyboardIndicator.KeyState {
         id: capsLockState
         key: Qt.Key_CapsLock
@@ -60,6 +70,7 @@ Item {
 -            }
 -            */
             PlasmaLogin.GreeterState.clearPasswords();
+            PlasmaLogin.BlurScreenBridge.setScreensOff();
         }
     }
 
@@ -98,7 +109,8 @@ Item {
         BreezeComponents.Clock {
             id: clock
             property Item shadow: clockShadow
-            visible: y > 0 && Settings.showClock
+            // nothing to tick for while the screens are off
+            visible: y > 0 && Settings.showClock && !PlasmaLogin.BlurScreenBridge.screensOff
             anchors.horizontalCenter: parent.horizontalCenter
             y: (userListComponent.userList.y + mainStack.y)/2 - height/2
             Layout.alignment: Qt.AlignBaseline
@@ -146,6 +158,11 @@ Item {
                 userListModel: PlasmaLogin.UserModel
                 loginScreenUiVisible: loginScreenRoot.uiVisible
                 userListCurrentIndex: {
+                    // the users are loaded asynchronously
+                    if (PlasmaLogin.UserModel.count === 0) {
+                        return 0;
+                    }
+
                     // indexOfData will return -1 if passed an empty string, which these are by default
                     let preselectedUserIndex = PlasmaLogin.UserModel.indexOfData(PlasmaLogin.Settings.preselectedUser, PlasmaLogin.UserModel.NameRole);
                     let lastLoggedInUserIndex = PlasmaLogin.UserModel.indexOfData(PlasmaLogin.StateConfig.lastLoggedInUser, PlasmaLogin.UserModel.NameRole);
@@ -305,7 +322,7 @@ Item {
                     Component.onCompleted: {
                         // as we can't bind inside ListElement
                         setProperty(0, "realName", i18nd("plasma_login", "Type in Username and Password"));
-                        setProperty(0, "icon", Qt.resolvedUrl(".face.icon").toString());
+                        setProperty(0, "icon", "image://avatar/" + encodeURIComponent(":/qt/qml/org/kde/plasma/login/.face.icon"));
                     }
                 }
 
@@ -400,6 +417,14 @@ Item {
             rejectPasswordAnimation.start();
         }
 
+        function onLoginBusy() {
+            notificationMessage = i18nd("plasma_login", "Another login is in progress, please try again");
+
+            footer.enabled = true;
+            mainStack.enabled = true;
+            userListComponent.userList.opacity = 1;
+        }
+
         function onLoginSucceeded() {
             mainStack.opacity = 0;
             footer.opacity = 0;
@@ -0,0 +1,39 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+// Writes the defaults of a look and feel package below $XDG_CONFIG_HOME.
+// Run by the auth helper, which can't do this itself as KLookAndFeelManager
+// has no other way to choose where the defaults go.
+
+#include <QCoreApplication>
+#include <QDebug>
+
+#include <KPackage/Package>
+#include <KPackage/PackageLoader>
+
+#include "klookandfeelmanager.h"
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    const QStringList args = app.arguments();
+    if (args.size() != 2) {
+        qWarning() << "Usage:" << args.value(0) << "<look and feel package>";
+        return EXIT_FAILURE;
+    }
+
+    const KPackage::Package package = KPackage::PackageLoader::self()->loadPackage(QStringLiteral("Plasma/LookAndFeel"), args.at(1));
+    if (!package.isValid()) {
+        qWarning() << "Could not load look and feel package" << args.at(1);
+        return EXIT_FAILURE;
+    }
+
+    KLookAndFeelManager lnfManager;
+    lnfManager.setMode(KLookAndFeelManager::Mode::Defaults);
+    lnfManager.save(package, KLookAndFeelManager::AllSettings);
+    return EXIT_SUCCESS;
+}
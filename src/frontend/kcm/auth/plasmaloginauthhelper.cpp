@@ -10,28 +10,38 @@
 
 #include <dirent.h>
 #include <fcntl.h> /* Definition of O_* and S_* constants */
+#include <linux/fs.h> /* Definition of FICLONE */
 #include <linux/openat2.h> /* Definition of RESOLVE_* constants */
+#include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <sys/syscall.h> /* Definition of SYS_* constants */
 #include <sys/wait.h>
 #include <unistd.h>
 
 #include <QBuffer>
+#include <QCryptographicHash>
 #include <QDBusUnixFileDescriptor>
 #include <QDebug>
 #include <QDir>
+#include <QDirIterator>
 #include <QFile>
 #include <QFileInfo>
 #include <QMimeDatabase>
 #include <QMimeType>
+#include <QProcess>
+#include <QSaveFile>
 #include <QSharedPointer>
+#include <QTemporaryFile>
 
 #include <KConfig>
 #include <KConfigGroup>
 #include <KLazyLocalizedString>
 #include <KLocalizedString>
+#include <KPackage/Package>
+#include <KPackage/PackageLoader>
 #include <KUser>
 
+#include "klookandfeelmanager.h"
 
 static const QFile::Permissions standardPermissions = QFile::ReadOwner | QFile::WriteOwner | QFile::ReadGroup | QFile::ReadOther;
 static const QFile::Permissions standardDirectoryPermissions = QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner | QFile::ReadGroup | QFile::ExeGroup | QFile::ReadOther | QFile::ExeOther;
@@ -142,6 +152,179 @@ static bool adjustOwnershipRecursively(int dirFd, uid_t uid, gid_t gid, const QS
     return success;
 }
 
+/*
+ * Apply the defaults of the synced look and feel package once, as root, into
+ * PLASMALOGIN_LOOKANDFEEL_CACHE_DIR. The greeter only compares the stamp written
+ * here instead of loading the package and hashing the colour scheme on every start.
+ */
+static bool precomputeLookAndFeel(const QVariantMap &args)
+{
+    const QString cacheDir = QStringLiteral(PLASMALOGIN_LOOKANDFEEL_CACHE_DIR);
+    const QString stagingDir = cacheDir + QStringLiteral(".new");
+    QDir(stagingDir).removeRecursively();
+    if (!QDir().mkpath(stagingDir)) {
+        qWarning() << "Could not create" << stagingDir;
+        return false;
+    }
+    auto removeStaging = qScopeGuard([stagingDir]() {
+        QDir(stagingDir).removeRecursively();
+    });
+
+    // Parse the kdeglobals we were given rather than the copy in the greeter's home
+    QTemporaryFile globalsFile;
+    if (!globalsFile.open()) {
+        return false;
+    }
+    globalsFile.write(args.value(QStringLiteral("kdeglobals")).toString().toUtf8());
+    globalsFile.flush();
+    KConfig globals(globalsFile.fileName(), KConfig::SimpleConfig);
+    const QString packageName = KConfigGroup(&globals, QStringLiteral("KDE")).readEntry("LookAndFeelPackage", QStringLiteral("org.kde.breeze.desktop"));
+
+    const KPackage::Package package = KPackage::PackageLoader::self()->loadPackage(QStringLiteral("Plasma/LookAndFeel"), packageName);
+    if (!package.isValid()) {
+        qWarning() << "Could not load look and feel package" << packageName;
+        return false;
+    }
+
+    // Nothing to do if neither the synced kdeglobals nor the package changed since last time
+    const QString version = packageName + QLatin1Char('/') + package.metadata().version();
+    const QString globalsHash = QString::fromLatin1(
+        QCryptographicHash::hash(args.value(QStringLiteral("kdeglobals")).toString().toUtf8(), QCryptographicHash::Sha256).toHex());
+    {
+        const KConfig currentStamp(cacheDir + QStringLiteral("/stamp"), KConfig::SimpleConfig);
+        const KConfigGroup current(&currentStamp, QStringLiteral("LookAndFeel"));
+        if (current.readEntry("Version", QString()) == version && current.readEntry("GlobalsHash", QString()) == globalsHash) {
+            return true;
+        }
+    }
+
+    // KLookAndFeelManager writes the defaults below XDG_CONFIG_HOME, so do it in
+    // a separate process; this one has other threads and mustn't just fork
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert(QStringLiteral("XDG_CONFIG_HOME"), stagingDir);
+    QProcess defaults;
+    defaults.setProcessEnvironment(env);
+    defaults.setProcessChannelMode(QProcess::ForwardedChannels);
+    defaults.start(QStringLiteral(PLASMALOGIN_LIBEXEC_DIR "/plasmalogin-lookandfeel-defaults"), {packageName});
+    if (!defaults.waitForFinished(-1) || defaults.exitStatus() != QProcess::NormalExit || defaults.exitCode() != EXIT_SUCCESS) {
+        qWarning() << "Failed to apply look and feel defaults" << defaults.errorString();
+        return false;
+    }
+
+    // Same lookup order as the greeter: the synced kdeglobals first, then the new defaults
+    KConfig defaultGlobals(stagingDir + QStringLiteral("/kdedefaults/kdeglobals"), KConfig::SimpleConfig);
+    const QString defaultColorScheme = KConfigGroup(&defaultGlobals, QStringLiteral("General")).readEntry("ColorScheme", QStringLiteral("BreezeLight"));
+    const QString colorScheme = KConfigGroup(&globals, QStringLiteral("General")).readEntry("ColorScheme", defaultColorScheme);
+    QString colorSchemeHash;
+    QFile colorSchemeFile(KLookAndFeelManager().colorSchemeFile(colorScheme));
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (colorSchemeFile.open(QFile::ReadOnly) && hash.addData(&colorSchemeFile)) {
+        colorSchemeHash = QString::fromUtf8(hash.result().toHex());
+    }
+
+    {
+        KConfig stamp(stagingDir + QStringLiteral("/stamp"), KConfig::SimpleConfig);
+        KConfigGroup group(&stamp, QStringLiteral("LookAndFeel"));
+        group.writeEntry("Package", packageName);
+        group.writeEntry("Version", version);
+        group.writeEntry("GlobalsHash", globalsHash);
+        group.writeEntry("ColorScheme", colorScheme);
+        group.writeEntry("ColorSchemeHash", colorSchemeHash);
+        if (!stamp.sync()) {
+            return false;
+        }
+    }
+
+    // root owned and read-only for the greeter
+    QDirIterator it(stagingDir, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QFileInfo info = it.nextFileInfo();
+        if (!info.isSymLink()) {
+            QFile::setPermissions(info.filePath(), info.isDir() ? standardDirectoryPermissions : standardPermissions);
+        }
+    }
+    QFile::setPermissions(stagingDir, standardDirectoryPermissions);
+
+    QDir(cacheDir).removeRecursively();
+    if (rename(QFile::encodeName(stagingDir).constData(), QFile::encodeName(cacheDir).constData()) != 0) {
+        qWarning() << "Could not move look and feel cache into place:" << strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+static QByteArray fileHash(const QString &path)
+{
+    QFile file(path);
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    if (!file.open(QFile::ReadOnly) || !hash.addData(&file)) {
+        return {};
+    }
+    return hash.result();
+}
+
+/*
+ * Build the greeter's fontconfig cache, as the plasmalogin user, so the greeter
+ * doesn't have to at its next start. It is kept outside ~/.cache, which sync
+ * wipes whenever the theme changes, and only rebuilt when fonts.conf changed.
+ */
+static bool updateFontCache(const QString &homeDir)
+{
+    const QString cacheDir = homeDir + QStringLiteral("/.local/state/fontconfig");
+    const QString stampPath = cacheDir + QStringLiteral("/plasmalogin-stamp");
+
+    // Listed ahead of the default cache directories through the user conf.d, so
+    // it is where fontconfig writes to; still reads the system caches
+    const QString confDir = homeDir + QStringLiteral("/.config/fontconfig/conf.d");
+    const QString confPath = confDir + QStringLiteral("/00-plasmalogin-cachedir.conf");
+    const QByteArray conf = QByteArrayLiteral("<?xml version=\"1.0\"?>\n"
+                                              "<!DOCTYPE fontconfig SYSTEM \"urn:fontconfig:fonts.dtd\">\n"
+                                              "<fontconfig>\n  <cachedir>")
+        + cacheDir.toHtmlEscaped().toUtf8() + QByteArrayLiteral("</cachedir>\n</fontconfig>\n");
+
+    if (!QDir().mkpath(confDir) || !QDir().mkpath(cacheDir)) {
+        qWarning() << "Could not create the font cache directories";
+        return false;
+    }
+    if (fileHash(confPath) != QCryptographicHash::hash(conf, QCryptographicHash::Sha256)) {
+        QSaveFile file(confPath);
+        if (!file.open(QIODevice::WriteOnly) || file.write(conf) != conf.size() || !file.commit()) {
+            qWarning() << "Could not write" << confPath << file.errorString();
+            return false;
+        }
+        QFile::setPermissions(confPath, standardPermissions);
+    }
+
+    const QByteArray stamp = (fileHash(homeDir + QStringLiteral("/.config/fontconfig/fonts.conf")) + fileHash(confPath)).toHex();
+    QFile stampFile(stampPath);
+    if (stampFile.open(QIODevice::ReadOnly) && stampFile.readAll() == stamp) {
+        return true;
+    }
+    stampFile.close();
+
+    // fontconfig finds the user configuration through $HOME, which is still root's here
+    pid_t pid = fork();
+    if (pid < 0) {
+        qWarning() << "Failed to fork fc-cache";
+        return false;
+    } else if (pid == 0) {
+        const QByteArray home = "HOME=" + QFile::encodeName(homeDir);
+        char *const argv[] = {const_cast<char *>("fc-cache"), nullptr};
+        char *const envp[] = {const_cast<char *>(home.constData()), const_cast<char *>("PATH=/usr/local/bin:/usr/bin:/bin"), nullptr};
+        execvpe("fc-cache", argv, envp);
+        _exit(127);
+    }
+
+    int status;
+    if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        qWarning() << "fc-cache failed for the plasmalogin user";
+        return false;
+    }
+
+    QSaveFile file(stampPath);
+    return file.open(QIODevice::WriteOnly) && file.write(stamp) == stamp.size() && file.commit();
+}
+
 bool PlasmaLoginAuthHelper::adjustPermissionsFromPlasma6_6()
 {
     // Plasma 6.6 ran some things as root. For 6.7 onwards we run them as the
@@ -158,6 +341,13 @@ bool PlasmaLoginAuthHelper::adjustPermissionsFromPlasma6_6()
         return false;
     }
 
+    // The repair only has to happen once, don't walk the whole home on every sync
+    const QByteArray markerPath = QFile::encodeName(homeDirPath + QStringLiteral("/.ownership-migrated"));
+    struct stat markerStat;
+    if (lstat(markerPath.constData(), &markerStat) == 0) {
+        return true;
+    }
+
     const QByteArray homeDirPathUtf8 = homeDirPath.toUtf8();
     const int homeDirFd = open(homeDirPathUtf8.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC | O_NOFOLLOW);
     if (homeDirFd < 0) {
@@ -165,7 +355,16 @@ bool PlasmaLoginAuthHelper::adjustPermissionsFromPlasma6_6()
         return false;
     }
 
-    return adjustOwnershipRecursively(homeDirFd, user.userId().nativeId(), user.groupId().nativeId(), homeDirPath);
+    if (!adjustOwnershipRecursively(homeDirFd, user.userId().nativeId(), user.groupId().nativeId(), homeDirPath)) {
+        return false;
+    }
+
+    // O_EXCL and O_NOFOLLOW: the home is writable by the plasmalogin user
+    const int markerFd = open(markerPath.constData(), O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (markerFd >= 0) {
+        close(markerFd);
+    }
+    return true;
 }
 
 ActionReply PlasmaLoginAuthHelper::sync(const QVariantMap &args)
@@ -182,15 +381,6 @@ ActionReply PlasmaLoginAuthHelper::sync(const QVariantMap &args)
     }
 
     bool rc = runAsPlasmaLoginUser([args, homeDir]() {
-        // In plasma-framework, ThemePrivate::useCache documents the requirement to
-        // clear the cache when colors change while the app that uses them isn't
-        // running; that condition applies to the greeter here, so clear the cache
-        // if it exists to make sure plasma login has a fresh state
-        QDir cacheLocation(homeDir + QStringLiteral("/.cache"));
-        if (cacheLocation.exists()) {
-            cacheLocation.removeRecursively();
-        }
-
         QDir homeLocation(homeDir);
 
         // Create config location if it does not exist
@@ -205,19 +395,32 @@ ActionReply PlasmaLoginAuthHelper::sync(const QVariantMap &args)
             configLocation.mkdir(QStringLiteral("fontconfig"), standardDirectoryPermissions);
         }
 
-        auto createConfigFile = [&args, &homeDir](const QString &name) {
+        // Only files whose content differs are replaced, so unchanged settings don't
+        // invalidate anything the greeter derived from them
+        QStringList changed;
+        auto createConfigFile = [&args, &homeDir, &changed](const QString &name) {
+            const QString path = homeDir + QStringLiteral("/.config/") + name;
+
             // Don't create config for any file we weren't given - and remove any
             // existing config as it does not exist in the user's config folder
-            if (!args.keys().contains(name)) {
-                QFile(homeDir + QStringLiteral("/.config/")).remove();
+            if (!args.contains(name)) {
+                if (QFile::remove(path)) {
+                    changed << name;
+                }
+                return;
+            }
+
+            const QByteArray content = args.value(name).toString().toUtf8();
+            if (fileHash(path) == QCryptographicHash::hash(content, QCryptographicHash::Sha256)) {
                 return;
             }
 
-            const QString content = args.value(name).toString();
-            QFile file(homeDir + QStringLiteral("/.config/") + name);
-            if (file.open(QFile::WriteOnly | QFile::Text | QFile::Truncate, standardPermissions)) {
-                QTextStream out(&file);
-                out << content;
+            QSaveFile file(path);
+            if (file.open(QIODevice::WriteOnly) && file.write(content) == content.size() && file.commit()) {
+                QFile::setPermissions(path, standardPermissions);
+                changed << name;
+            } else {
+                qWarning() << "Could not write" << path << file.errorString();
             }
         };
 
@@ -234,9 +437,30 @@ ActionReply PlasmaLoginAuthHelper::sync(const QVariantMap &args)
         createConfigFile(QStringLiteral("kwinoutputconfig.json"));
 
         createConfigFile(QStringLiteral("fontconfig/fonts.conf"));
+
+        // In plasma-framework, ThemePrivate::useCache documents the requirement to
+        // clear the cache when colors change while the app that uses them isn't
+        // running; that condition applies to the greeter here, so clear the cache
+        // if the theme or colors changed to make sure plasma login has a fresh state
+        if (changed.contains(QStringLiteral("kdeglobals")) || changed.contains(QStringLiteral("plasmarc"))) {
+            QDir cacheLocation(homeDir + QStringLiteral("/.cache"));
+            if (cacheLocation.exists()) {
+                cacheLocation.removeRecursively();
+            }
+        }
+
+        // Not fatal, the greeter builds what is missing itself
+        if (!updateFontCache(homeDir)) {
+            qWarning() << "Could not update the greeter font cache";
+        }
         return true;
     });
 
+    // Not fatal, without the cache the greeter applies the look and feel itself
+    if (rc && !precomputeLookAndFeel(args)) {
+        qWarning() << "Could not precompute the greeter look and feel";
+    }
+
     if (rc) {
         return ActionReply::SuccessReply();
     } else {
@@ -272,9 +496,14 @@ ActionReply PlasmaLoginAuthHelper::reset(const QVariantMap &args)
             configDir.removeRecursively();
         }
 
+        // Only used through the config removed above
+        QDir(homeDir + QStringLiteral("/.local/state/fontconfig")).removeRecursively();
+
         return true;
     });
 
+    QDir(QStringLiteral(PLASMALOGIN_LOOKANDFEEL_CACHE_DIR)).removeRecursively();
+
     if (rc) {
         return ActionReply::SuccessReply();
     } else {
@@ -298,6 +527,124 @@ static bool isRegularFd(int fd)
     return S_ISREG(st.st_mode);
 }
 
+static bool copyFd(int inFd, int outFd)
+{
+    // Share the extents when the filesystem supports it
+    if (ioctl(outFd, FICLONE, inFd) == 0) {
+        return true;
+    }
+
+    char buf[64 * 1024];
+    off_t offset = 0;
+    while (true) {
+        const ssize_t n = pread(inFd, buf, sizeof(buf), offset);
+        if (n == 0) {
+            return true;
+        } else if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        for (ssize_t written = 0; written < n;) {
+            const ssize_t w = write(outFd, buf + written, n - written);
+            if (w < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            written += w;
+        }
+        offset += n;
+    }
+}
+
+/*
+ * Return the SHA-256 of the contents of @p fd in hex, empty on errors
+ */
+static QByteArray hashFd(int fd)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    char buf[64 * 1024];
+    off_t offset = 0;
+    while (true) {
+        const ssize_t n = pread(fd, buf, sizeof(buf), offset);
+        if (n == 0) {
+            break;
+        } else if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return {};
+        }
+        hash.addData(QByteArrayView(buf, n));
+        offset += n;
+    }
+    return hash.result().toHex();
+}
+
+/*
+ * Add the contents of @p inFd to the wallpaper store, unless an identical image
+ * is already there, and return the name of the object (its SHA-256).
+ */
+static QByteArray storeWallpaper(int storeFd, int inFd)
+{
+    // The file belongs to the client and may change while we read it, so the
+    // object is named after the hash of our copy rather than of the original.
+    const QByteArray tempName = ".tmp-" + QByteArray::number(getpid());
+    unlinkat(storeFd, tempName.constData(), 0);
+    const int outFd = openat(storeFd, tempName.constData(), O_RDWR | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (outFd < 0) {
+        return {};
+    }
+    const QByteArray object = copyFd(inFd, outFd) ? hashFd(outFd) : QByteArray();
+    close(outFd);
+    if (object.isEmpty()) {
+        unlinkat(storeFd, tempName.constData(), 0);
+        return {};
+    }
+
+    struct stat st;
+    if (fstatat(storeFd, object.constData(), &st, AT_SYMLINK_NOFOLLOW) == 0 && S_ISREG(st.st_mode)) {
+        unlinkat(storeFd, tempName.constData(), 0);
+        return object;
+    }
+
+    if (renameat(storeFd, tempName.constData(), storeFd, object.constData()) != 0) {
+        unlinkat(storeFd, tempName.constData(), 0);
+        return {};
+    }
+    return object;
+}
+
+/*
+ * Drop store objects no wallpaper links to anymore
+ */
+static void pruneWallpaperStore(int storeFd)
+{
+    const int dirFd = fcntl(storeFd, F_DUPFD_CLOEXEC, 0);
+    if (dirFd < 0) {
+        return;
+    }
+    DIR *dir = fdopendir(dirFd);
+    if (!dir) {
+        close(dirFd);
+        return;
+    }
+    while (dirent *entry = readdir(dir)) {
+        const QByteArray name(entry->d_name);
+        if (name == "." || name == "..") {
+            continue;
+        }
+        struct stat st;
+        if (fstatat(storeFd, name.constData(), &st, AT_SYMLINK_NOFOLLOW) == 0 && (!S_ISREG(st.st_mode) || st.st_nlink <= 1)) {
+            unlinkat(storeFd, name.constData(), 0);
+        }
+    }
+    closedir(dir);
+}
+
 ActionReply PlasmaLoginAuthHelper::save(const QVariantMap &args)
 {
     QFile file(QLatin1String(PLASMALOGIN_CONFIG_FILE));
@@ -352,6 +699,18 @@ ActionReply PlasmaLoginAuthHelper::save(const QVariantMap &args)
             close(rootWallpaperFd);
         });
 
+        // Image data lives in a content-addressed store, the wallpaper tree only holds hard links to it
+        homeDir.mkdir(QStringLiteral("wallpaper-store"));
+        const int storeFd = open(QFile::encodeName(homeDir.absoluteFilePath(QStringLiteral("wallpaper-store"))).constData(),
+                                 O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        if (storeFd < 0) {
+            qWarning() << "Could not open wallpaper store." << qPrintable(strerror(errno));
+            return false;
+        }
+        auto closeStoreFd = qScopeGuard([&]() {
+            close(storeFd);
+        });
+
         const QStringList wallpapers = args[QStringLiteral("wallpapers")].toStringList();
         for (const QString &wallpaper : wallpapers) {
             // This shouldn't be needed with the explicit openat flags, but
@@ -368,44 +727,36 @@ ActionReply PlasmaLoginAuthHelper::save(const QVariantMap &args)
                 return false;
             }
 
-            struct open_how how = {.flags = O_CREAT | O_WRONLY | O_TRUNC,
-                                   .mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH,
-                                   .resolve = RESOLVE_BENEATH | RESOLVE_NO_MAGICLINKS};
-            int outFd = syscall(SYS_openat2, rootWallpaperFd, wallpaper.toUtf8().constData(), &how, sizeof(struct open_how));
-            if (outFd < 0) {
-                qWarning() << "Could not open wallpaper file." << qPrintable(strerror(errno));
-                return false;
-            }
-            QFile file;
-            if (!file.open(outFd, QIODevice::WriteOnly | QIODevice::Truncate, QFileDevice::AutoCloseHandle)) {
-                qWarning() << "Could not open wallpaper directory from FD.";
-                return false;
-            }
-
-            QDataStream out(&file);
             QDBusUnixFileDescriptor fd = args.value("_fd_" + wallpaper).value<QDBusUnixFileDescriptor>();
             if (!fd.isValid() || !isRegularFd(fd.fileDescriptor())) {
                 qWarning() << "Could not retrieve wallpaper" << wallpaper;
                 continue;
             }
-            QFile wallpaperIn;
-            if (!wallpaperIn.open(fd.fileDescriptor(), QIODevice::ReadOnly)) {
-                qWarning() << "Failed to open wallpaper";
+
+            const QByteArray object = storeWallpaper(storeFd, fd.fileDescriptor());
+            if (object.isEmpty()) {
+                qWarning() << "Failed to transfer wallpaper data for file" << relativeFilePath;
                 return false;
             }
-            QByteArray buf(4096, 0);
-            while (true) {
-                qint64 n = wallpaperIn.read(buf.data(), buf.size());
-                if (n == 0) {
-                    break;
-                } else if (n < 0) {
-                    qWarning() << "Failed to transfer wallpaper data for file" << relativeFilePath;
-                    return false;
-                } else {
-                    out.writeRawData(buf.data(), n);
-                }
+
+            const qsizetype slash = wallpaper.lastIndexOf(QLatin1Char('/'));
+            const QByteArray parent = slash < 0 ? QByteArray(".") : wallpaper.left(slash).toUtf8();
+            const QByteArray fileName = wallpaper.mid(slash + 1).toUtf8();
+            struct open_how how = {.flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC, .mode = 0, .resolve = RESOLVE_BENEATH | RESOLVE_NO_MAGICLINKS};
+            const int parentFd = syscall(SYS_openat2, rootWallpaperFd, parent.constData(), &how, sizeof(struct open_how));
+            if (parentFd < 0) {
+                qWarning() << "Could not open wallpaper directory." << qPrintable(strerror(errno));
+                return false;
+            }
+            const int linked = linkat(storeFd, object.constData(), parentFd, fileName.constData(), 0);
+            close(parentFd);
+            if (linked != 0) {
+                qWarning() << "Could not link wallpaper" << relativeFilePath << qPrintable(strerror(errno));
+                return false;
             }
         }
+
+        pruneWallpaperStore(storeFd);
         return true;
     });
 
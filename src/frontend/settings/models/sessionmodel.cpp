@@ -6,7 +6,9 @@
 
 #include <QDir>
 #include <QFileSystemWatcher>
+#include <QFutureWatcher>
 #include <QStandardPaths>
+#include <QtConcurrentRun>
 
 #include <KDesktopFile>
 #include <KLocalizedString>
@@ -16,21 +18,52 @@
 SessionModel::SessionModel(QObject *parent)
     : QAbstractListModel(parent)
 {
-    // NOTE: /usr/local/share is listed first, then /usr/share, so sessions in the former take precedence
-    const QStringList xSessionsDirs =
-        QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QStringLiteral("xsessions"), QStandardPaths::LocateDirectory);
-    const QStringList waylandSessionsDirs =
-        QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QStringLiteral("wayland-sessions"), QStandardPaths::LocateDirectory);
-
     // NOTE: SDDM checks for the existence of /dev/dri before including wayland sessions
     // This is not duplicated here — if wayland isn't going to work, then neither is the greeter
 
-    populate(xSessionsDirs, waylandSessionsDirs);
+    setSessions(collectSessions(xSessionsDirs(), waylandSessionsDirs()));
+    watchSessionsDirs();
+}
+
+SessionModel::SessionModel(const QFuture<QList<Session>> &sessions, QObject *parent)
+    : QAbstractListModel(parent)
+{
+    auto watcher = new QFutureWatcher<QList<Session>>(this);
+    connect(watcher, &QFutureWatcher<QList<Session>>::finished, this, [this, watcher]() {
+        setSessions(watcher->result());
+        watcher->deleteLater();
+        watchSessionsDirs();
+    });
+    watcher->setFuture(sessions);
+}
+
+QFuture<QList<Session>> SessionModel::loadSessions()
+{
+    return QtConcurrent::run([]() {
+        return collectSessions(xSessionsDirs(), waylandSessionsDirs());
+    });
+}
+
+QStringList SessionModel::xSessionsDirs()
+{
+    // NOTE: /usr/local/share is listed first, then /usr/share, so sessions in the former take precedence
+    return QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QStringLiteral("xsessions"), QStandardPaths::LocateDirectory);
+}
+
+QStringList SessionModel::waylandSessionsDirs()
+{
+    return QStandardPaths::locateAll(QStandardPaths::GenericDataLocation, QStringLiteral("wayland-sessions"), QStandardPaths::LocateDirectory);
+}
+
+void SessionModel::watchSessionsDirs()
+{
+    const QStringList xDirs = xSessionsDirs();
+    const QStringList waylandDirs = waylandSessionsDirs();
 
     QFileSystemWatcher *watcher = new QFileSystemWatcher(this);
-    watcher->addPaths(xSessionsDirs + waylandSessionsDirs);
-    connect(watcher, &QFileSystemWatcher::directoryChanged, [this, xSessionsDirs, waylandSessionsDirs]() {
-        populate(xSessionsDirs, waylandSessionsDirs);
+    watcher->addPaths(xDirs + waylandDirs);
+    connect(watcher, &QFileSystemWatcher::directoryChanged, [this, xDirs, waylandDirs]() {
+        setSessions(collectSessions(xDirs, waylandDirs));
     });
 }
 
@@ -140,21 +173,27 @@ int SessionModel::indexOfData(const QVariant &data, int role) const
     return -1;
 }
 
-void SessionModel::populate(const QStringList &xSessionsPaths, const QStringList &waylandSessionsPaths)
+void SessionModel::setSessions(const QList<Session> &sessions)
 {
     beginResetModel();
+    m_sessions = sessions;
+    endResetModel();
+    Q_EMIT countChanged();
+}
 
-    m_sessions.clear();
+QList<Session> SessionModel::collectSessions(const QStringList &xSessionsPaths, const QStringList &waylandSessionsPaths)
+{
+    QList<Session> sessions;
 
     for (const auto &xSession : getSessionsPaths(xSessionsPaths)) {
-        m_sessions << getSession(xSession, Session::Type::X11);
+        sessions << getSession(xSession, Session::Type::X11);
     }
 
     for (const auto &waylandSession : getSessionsPaths(waylandSessionsPaths)) {
-        m_sessions << getSession(waylandSession, Session::Type::Wayland);
+        sessions << getSession(waylandSession, Session::Type::Wayland);
     }
 
-    std::sort(m_sessions.begin(), m_sessions.end(), [](const Session &a, const Session &b) {
+    std::sort(sessions.begin(), sessions.end(), [](const Session &a, const Session &b) {
         // Plasma first
         const bool aIsPlasma = QFileInfo(a.path).fileName().startsWith(QStringLiteral("plasma"));
         const bool bIsPlasma = QFileInfo(b.path).fileName().startsWith(QStringLiteral("plasma"));
@@ -182,10 +221,10 @@ void SessionModel::populate(const QStringList &xSessionsPaths, const QStringList
         }
     });
 
-    endResetModel();
+    return sessions;
 }
 
-QStringList SessionModel::getSessionsPaths(const QStringList &sessionsDirs) const
+QStringList SessionModel::getSessionsPaths(const QStringList &sessionsDirs)
 {
     QStringList sessionsPaths;
 
@@ -210,7 +249,7 @@ QStringList SessionModel::getSessionsPaths(const QStringList &sessionsDirs) cons
     return sessionsPaths;
 }
 
-Session SessionModel::getSession(const QString path, const Session::Type type) const
+Session SessionModel::getSession(const QString path, const Session::Type type)
 {
     qDebug().nospace() << "Reading session (" << type << ") from " << path;
 
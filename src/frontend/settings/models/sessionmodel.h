@@ -5,6 +5,7 @@
  */
 #pragma once
 #include <QAbstractListModel>
+#include <QFuture>
 #include <QUrl>
 
 struct Session {
@@ -31,8 +32,14 @@ class SessionModel : public QAbstractListModel
 {
     Q_OBJECT
 
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
 public:
     SessionModel(QObject *parent = nullptr);
+    /**
+     * Takes the sessions from loadSessions(), the model is empty until they are loaded
+     */
+    explicit SessionModel(const QFuture<QList<Session>> &sessions, QObject *parent = nullptr);
     ~SessionModel() override = default;
 
     enum SessionRoles {
@@ -50,10 +57,22 @@ public:
 
     Q_INVOKABLE int indexOfData(const QVariant &data, int role = Qt::DisplayRole) const;
 
+    /**
+     * Reads the installed sessions on a worker thread
+     */
+    static QFuture<QList<Session>> loadSessions();
+
+Q_SIGNALS:
+    void countChanged();
+
 private:
-    void populate(const QStringList &xSessionsDirs, const QStringList &waylandSessionsDirs);
-    QStringList getSessionsPaths(const QStringList &sessionsDirs) const;
-    Session getSession(const QString path, const Session::Type type) const;
+    void watchSessionsDirs();
+    void setSessions(const QList<Session> &sessions);
+    static QStringList xSessionsDirs();
+    static QStringList waylandSessionsDirs();
+    static QList<Session> collectSessions(const QStringList &xSessionsPaths, const QStringList &waylandSessionsPaths);
+    static QStringList getSessionsPaths(const QStringList &sessionsDirs);
+    static Session getSession(const QString path, const Session::Type type);
 
     QList<Session> m_sessions;
 };
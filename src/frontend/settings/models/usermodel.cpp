@@ -4,6 +4,9 @@
  *  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
  */
 
+#include <QFutureWatcher>
+#include <QtConcurrentRun>
+
 #include <KUser>
 
 #include <pwd.h>
@@ -16,7 +19,26 @@ UserModel::UserModel(QObject *parent)
     : QAbstractListModel(parent)
 {
     // TODO: Should use settings for uid limits, and repopulate on change
-    populate();
+    setUsers(collectUsers(PlasmaLoginSettings::getInstance().minimumUid(), PlasmaLoginSettings::getInstance().maximumUid()));
+}
+
+UserModel::UserModel(const QFuture<QList<User>> &users, QObject *parent)
+    : QAbstractListModel(parent)
+{
+    auto watcher = new QFutureWatcher<QList<User>>(this);
+    connect(watcher, &QFutureWatcher<QList<User>>::finished, this, [this, watcher]() {
+        setUsers(watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(users);
+}
+
+QFuture<QList<User>> UserModel::loadUsers()
+{
+    // The settings aren't thread safe, read them here
+    const unsigned int minimumUid = PlasmaLoginSettings::getInstance().minimumUid();
+    const unsigned int maximumUid = PlasmaLoginSettings::getInstance().maximumUid();
+    return QtConcurrent::run(&UserModel::collectUsers, minimumUid, maximumUid);
 }
 
 int UserModel::rowCount(const QModelIndex &parent) const
@@ -40,6 +62,11 @@ QVariant UserModel::data(const QModelIndex &index, int role) const
     case UserModel::RealNameRole:
         return user.realName;
     case UserModel::IconRole:
+        if (!m_iconProvider.isEmpty()) {
+            const QUrl url(user.icon);
+            const QString path = url.isLocalFile() ? url.toLocalFile() : QLatin1Char(':') + url.path();
+            return QStringLiteral("image://%1/%2").arg(m_iconProvider, QString::fromLatin1(QUrl::toPercentEncoding(path)));
+        }
         return user.icon;
     case UserModel::HomeDirRole:
         return user.homeDir;
@@ -82,11 +109,28 @@ int UserModel::indexOfData(const QVariant &data, int role) const
     return -1;
 }
 
-void UserModel::populate()
+void UserModel::setIconProvider(const QString &providerId)
+{
+    if (m_iconProvider == providerId) {
+        return;
+    }
+
+    beginResetModel();
+    m_iconProvider = providerId;
+    endResetModel();
+}
+
+void UserModel::setUsers(const QList<User> &users)
 {
     beginResetModel();
+    m_users = users;
+    endResetModel();
+    Q_EMIT countChanged();
+}
 
-    m_users.clear();
+QList<User> UserModel::collectUsers(unsigned int minimumUid, unsigned int maximumUid)
+{
+    QList<User> users;
 
     for (const KUser &user : KUser::allUsers()) {
         if (!user.isValid()) {
@@ -101,15 +145,18 @@ void UserModel::populate()
         const bool cannotLogin = user.shell().endsWith("/nologin") || user.shell().endsWith("/false");
         
         // Consider UID ranges (homed range from systemd: HOME_UID_MIN, HOME_UID_MAX)
-        const bool inLogindDefRange = (uid >= PlasmaLoginSettings::getInstance().minimumUid() && uid <= PlasmaLoginSettings::getInstance().maximumUid());
+        const bool inLogindDefRange = (uid >= minimumUid && uid <= maximumUid);
         const bool inHomedRange = (uid >= 60001 && uid <= 60513);
         
         if (cannotLogin || (!inLogindDefRange && !inHomedRange)) {
             continue;
         }
 
-        struct passwd *pw = getpwuid(uid);
-        if (!pw) {
+        // may run on a worker thread, so use the reentrant variant
+        struct passwd pwd;
+        struct passwd *pw = nullptr;
+        char buffer[4096];
+        if (getpwuid_r(uid, &pwd, buffer, sizeof(buffer), &pw) != 0 || !pw) {
             qWarning() << "Failed to determine if user requires password for login";
             continue;
         }
@@ -122,10 +169,10 @@ void UserModel::populate()
             icon.prepend(QStringLiteral("file://"));
         }
 
-        m_users << User(user.loginName(), user.property(KUser::UserProperty::FullName).toString(), icon, user.homeDir(), needsPassword, uid, gid);
+        users << User(user.loginName(), user.property(KUser::UserProperty::FullName).toString(), icon, user.homeDir(), needsPassword, uid, gid);
     }
 
-    endResetModel();
+    return users;
 }
 
 #include "moc_usermodel.cpp"
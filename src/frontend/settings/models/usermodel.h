@@ -7,6 +7,7 @@
 #pragma once
 
 #include <QAbstractListModel>
+#include <QFuture>
 #include <QUrl>
 
 struct User {
@@ -34,10 +35,14 @@ class UserModel : public QAbstractListModel
 {
     Q_OBJECT
 
-    Q_PROPERTY(int count READ rowCount CONSTANT)
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
 
 public:
     UserModel(QObject *parent = nullptr);
+    /**
+     * Takes the users from loadUsers(), the model is empty until they are loaded
+     */
+    explicit UserModel(const QFuture<QList<User>> &users, QObject *parent = nullptr);
     ~UserModel() override = default;
 
     enum UserRoles {
@@ -58,8 +63,24 @@ public:
 
     Q_INVOKABLE int indexOfData(const QVariant &data, int role = Qt::DisplayRole) const;
 
+    /**
+     * Enumerates the users that can log in on a worker thread
+     */
+    static QFuture<QList<User>> loadUsers();
+
+    /**
+     * Hands out the icons as "image://<providerId>/<percent encoded path>"
+     * instead of plain URLs, so an image provider can load them
+     */
+    void setIconProvider(const QString &providerId);
+
+Q_SIGNALS:
+    void countChanged();
+
 private:
-    void populate();
+    static QList<User> collectUsers(unsigned int minimumUid, unsigned int maximumUid);
+    void setUsers(const QList<User> &users);
 
     QList<User> m_users;
+    QString m_iconProvider;
 };
@@ -0,0 +1,52 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QQuickGraphicsConfiguration>
+#include <QQuickWindow>
+#include <QSet>
+#include <QStandardPaths>
+
+#include "pipelinecache.h"
+
+void PipelineCache::setup(QQuickWindow *window, const QString &name)
+{
+    static const QString cacheDir = [] {
+        const QString dir = QStandardPaths::writableLocation(QStandardPaths::GenericStateLocation) + QStringLiteral("/plasmalogin/pipelines");
+        return QDir().mkpath(dir) ? dir : QString();
+    }();
+    if (cacheDir.isEmpty()) {
+        return;
+    }
+
+    // QRhi itself rejects data from another driver or GPU, the Qt version in
+    // the name makes a Qt update start from scratch
+    const QString fileName = QStringLiteral("%1-%2.cache").arg(name, QString::fromLatin1(qVersion()));
+
+    // Every window loads the cache, only the first of each kind saves it so
+    // windows closing together don't write the same file
+    static QSet<QString> saved;
+    const bool save = !saved.contains(name);
+    if (save) {
+        saved.insert(name);
+
+        const QStringList stale = QDir(cacheDir).entryList({name + QStringLiteral("-*.cache")}, QDir::Files);
+        for (const QString &file : stale) {
+            if (file != fileName) {
+                QFile::remove(cacheDir + QLatin1Char('/') + file);
+            }
+        }
+    }
+
+    const QString path = cacheDir + QLatin1Char('/') + fileName;
+    QQuickGraphicsConfiguration config = window->graphicsConfiguration();
+    config.setPipelineCacheLoadFile(path);
+    if (save) {
+        config.setPipelineCacheSaveFile(path);
+    }
+    window->setGraphicsConfiguration(config);
+}
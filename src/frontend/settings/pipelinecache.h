@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <QString>
+
+class QQuickWindow;
+
+namespace PipelineCache
+{
+/**
+ * Loads the graphics pipelines of @p window from, and saves them to, a file
+ * named after @p name in the state directory. Unlike ~/.cache it survives
+ * settings syncs, so shaders aren't compiled again on every start.
+ *
+ * Must be called before the window is shown.
+ */
+void setup(QQuickWindow *window, const QString &name);
+}
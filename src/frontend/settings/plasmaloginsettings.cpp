@@ -11,6 +11,10 @@
 #include <QCollator>
 #include <QDir>
 #include <QFile>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QQuickWindow>
 #include <QRegularExpression>
 #include <QTextStream>
 
@@ -34,6 +38,34 @@ static void addDirectoryToConfig(KSharedConfig::Ptr config, const QDir &dir)
     config->addConfigSources(sources);
 }
 
+static bool softwareRendering()
+{
+    if (QQuickWindow::graphicsApi() == QSGRendererInterface::Software || qEnvironmentVariableIntValue("LIBGL_ALWAYS_SOFTWARE")) {
+        return true;
+    }
+    if (QQuickWindow::graphicsApi() != QSGRendererInterface::OpenGL) {
+        return false;
+    }
+
+    QOpenGLContext context;
+    QOffscreenSurface surface;
+    if (!context.create()) {
+        // Qt Quick falls back to the software backend
+        return true;
+    }
+    surface.setFormat(context.format());
+    surface.create();
+    if (!context.makeCurrent(&surface)) {
+        return true;
+    }
+
+    const QByteArray renderer(reinterpret_cast<const char *>(context.functions()->glGetString(GL_RENDERER)));
+    context.doneCurrent();
+
+    qDebug() << "OpenGL renderer:" << renderer;
+    return renderer.contains("llvmpipe") || renderer.contains("softpipe") || renderer.contains("swrast") || renderer.contains("Software Rasterizer");
+}
+
 PlasmaLoginSettings &PlasmaLoginSettings::getInstance()
 {
     auto config = KSharedConfig::openConfig(QStringLiteral(PLASMALOGIN_CONFIG_FILE), KConfig::NoGlobals);
@@ -133,6 +165,26 @@ void PlasmaLoginSettings::getWallpaperPlugins()
     });
 }
 
+bool PlasmaLoginSettings::lightweight() const
+{
+    if (!m_lightweight) {
+        switch (lightweightMode()) {
+        case EnumLightweightMode::Enabled:
+            m_lightweight = true;
+            break;
+        case EnumLightweightMode::Disabled:
+            m_lightweight = false;
+            break;
+        default:
+            m_lightweight = softwareRendering();
+            if (*m_lightweight) {
+                qDebug() << "Software rendering detected, using the lightweight greeter";
+            }
+        }
+    }
+    return *m_lightweight;
+}
+
 unsigned int PlasmaLoginSettings::minimumUid() const
 {
     return m_minimumUid;
@@ -9,6 +9,8 @@
 
 #include "plasmaloginsettingsbase.h"
 
+#include <optional>
+
 struct WallpaperInfo {
     Q_PROPERTY(QString name MEMBER name CONSTANT)
     Q_PROPERTY(QString id MEMBER id CONSTANT)
@@ -20,6 +22,7 @@ struct WallpaperInfo {
 class PlasmaLoginSettings : public PlasmaLoginSettingsBase
 {
     Q_OBJECT
+    Q_PROPERTY(bool lightweight READ lightweight CONSTANT)
 
 public:
     static PlasmaLoginSettings &getInstance();
@@ -31,6 +34,15 @@ public:
 
     QList<WallpaperInfo> availableWallpaperPlugins() const;
 
+    /**
+     * Whether to use the reduced-cost profile: no live blur, no animations and
+     * the login UI on the primary screen only. Follows LightweightMode, Auto
+     * enables it when Qt Quick renders in software or OpenGL is llvmpipe & co.
+     *
+     * Needs a QGuiApplication, resolved on first use.
+     */
+    bool lightweight() const;
+
     PlasmaLoginSettings(PlasmaLoginSettings const &) = delete;
     void operator=(PlasmaLoginSettings const &) = delete;
 
@@ -44,4 +56,5 @@ private:
     unsigned int m_minimumUid;
     unsigned int m_maximumUid;
     QList<WallpaperInfo> m_availableWallpaperPlugins;
+    mutable std::optional<bool> m_lightweight;
 };
@@ -15,6 +15,8 @@ QString PlasmaLoginSettingsDefaults::s_defaultPreselectedUser;
 QString PlasmaLoginSettingsDefaults::s_defaultPreselectedSession;
 bool PlasmaLoginSettingsDefaults::s_defaultShowClock;
 QString PlasmaLoginSettingsDefaults::s_defaultWallpaperPluginId;
+int PlasmaLoginSettingsDefaults::s_defaultLightweightMode;
+bool PlasmaLoginSettingsDefaults::s_defaultSingleProcess;
 
 PlasmaLoginSettingsDefaults::PlasmaLoginSettingsDefaults(KSharedConfigPtr config, QObject *parent)
     : KConfigSkeleton(config, parent)
@@ -27,6 +29,10 @@ PlasmaLoginSettingsDefaults::PlasmaLoginSettingsDefaults(KSharedConfigPtr config
     s_defaultPreselectedSession = defaultConfig->group(QStringLiteral("Greeter")).readEntry("PreselectedSession", "");
     s_defaultShowClock = defaultConfig->group(QStringLiteral("Greeter")).readEntry("ShowClock", true);
     s_defaultWallpaperPluginId = defaultConfig->group(QStringLiteral("Greeter")).readEntry("WallpaperPluginId", "org.kde.image");
+    // stored by choice name, in the order of the choices in plasmaloginsettingsbase.kcfg
+    const QStringList lightweightModes = {QStringLiteral("Auto"), QStringLiteral("Enabled"), QStringLiteral("Disabled")};
+    s_defaultLightweightMode = qMax(0, int(lightweightModes.indexOf(defaultConfig->group(QStringLiteral("Greeter")).readEntry("LightweightMode", "Auto"))));
+    s_defaultSingleProcess = defaultConfig->group(QStringLiteral("Greeter")).readEntry("SingleProcess", false);
 }
 
 QString PlasmaLoginSettingsDefaults::defaultUser()
@@ -64,4 +70,14 @@ QString PlasmaLoginSettingsDefaults::defaultWallpaperPluginId()
     return s_defaultWallpaperPluginId;
 }
 
+int PlasmaLoginSettingsDefaults::defaultLightweightMode()
+{
+    return s_defaultLightweightMode;
+}
+
+bool PlasmaLoginSettingsDefaults::defaultSingleProcess()
+{
+    return s_defaultSingleProcess;
+}
+
 #include "moc_plasmaloginsettingsdefaults.cpp"
@@ -19,6 +19,8 @@ class PlasmaLoginSettingsDefaults : public KConfigSkeleton
     Q_PROPERTY(QString defaultPreselectedSession READ defaultPreselectedSession CONSTANT)
     Q_PROPERTY(bool defaultShowClock READ defaultShowClock CONSTANT)
     Q_PROPERTY(QString defaultWallpaperPluginId READ defaultWallpaperPluginId CONSTANT)
+    Q_PROPERTY(int defaultLightweightMode READ defaultLightweightMode CONSTANT)
+    Q_PROPERTY(bool defaultSingleProcess READ defaultSingleProcess CONSTANT)
 
 public:
     PlasmaLoginSettingsDefaults(KSharedConfigPtr config, QObject *parent = nullptr);
@@ -30,6 +32,8 @@ public:
     static QString defaultPreselectedSession();
     static bool defaultShowClock();
     static QString defaultWallpaperPluginId();
+    static int defaultLightweightMode();
+    static bool defaultSingleProcess();
 
 private:
     static QString s_defaultUser;
@@ -39,4 +43,6 @@ private:
     static QString s_defaultPreselectedSession;
     static bool s_defaultShowClock;
     static QString s_defaultWallpaperPluginId;
+    static int s_defaultLightweightMode;
+    static bool s_defaultSingleProcess;
 };
@@ -19,12 +19,14 @@
 #include <QDBusArgument>
 #include <QDebug>
 #include <QDir>
-#include <QEventLoop>
+#include <QFileInfo>
 #include <QProcess>
 #include <QStandardPaths>
 
 #include <QDBusConnectionInterface>
 #include <QDBusMetaType>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
 #include <QDBusReply>
 #include <QDBusServiceWatcher>
 
@@ -34,6 +36,7 @@
 // #include <KNotifyConfig>
 #include <KPackage/Package>
 #include <KPackage/PackageLoader>
+#include <KPluginMetaData>
 #include <KSharedConfig>
 
 #include <signal.h>
@@ -189,14 +192,23 @@ void runStartupConfig()
     }
 }
 
-std::optional<QProcessEnvironment> getSystemdEnvironment()
+static QDBusMessage systemdEnvironmentMessage()
 {
     auto msg = QDBusMessage::createMethodCall(QStringLiteral("org.freedesktop.systemd1"),
                                               QStringLiteral("/org/freedesktop/systemd1"),
                                               QStringLiteral("org.freedesktop.DBus.Properties"),
                                               QStringLiteral("Get"));
     msg << QStringLiteral("org.freedesktop.systemd1.Manager") << QStringLiteral("Environment");
-    auto reply = QDBusConnection::sessionBus().call(msg);
+    return msg;
+}
+
+std::optional<QProcessEnvironment> getSystemdEnvironment()
+{
+    return systemdEnvironmentFromReply(QDBusConnection::sessionBus().call(systemdEnvironmentMessage()));
+}
+
+std::optional<QProcessEnvironment> systemdEnvironmentFromReply(const QDBusMessage &reply)
+{
     if (reply.type() == QDBusMessage::ErrorMessage) {
         return std::nullopt;
     }
@@ -291,6 +303,17 @@ static std::pair<QString, KLookAndFeelManager::Contents> determineLookAndFeel()
     return std::make_pair(settings.lookAndFeelPackage(), KLookAndFeelManager::AllSettings);
 }
 
+static QString lookAndFeelCacheKey(const QString &name)
+{
+    // Reading the metadata is much cheaper than loading the whole package
+    const QString metadata =
+        QStandardPaths::locate(QStandardPaths::GenericDataLocation, QLatin1String("plasma/look-and-feel/") + name + QLatin1String("/metadata.json"));
+    if (metadata.isEmpty()) {
+        return name;
+    }
+    return name + QLatin1Char('/') + KPluginMetaData::fromJsonFile(metadata).version();
+}
+
 void setupPlasmaEnvironment()
 {
     // Manually disable auto scaling because we are scaling above
@@ -311,30 +334,60 @@ void setupPlasmaEnvironment()
     const auto &[lookAndFeelName, lookAndFeelContents] = determineLookAndFeel();
     QFile activeLnf(extraConfigDir + QLatin1String("/package"));
     activeLnf.open(QIODevice::ReadOnly);
-    if (activeLnf.readLine() != lookAndFeelName.toUtf8()) {
+    // Applying the defaults only has to be redone when the package or its version changes
+    const QString lookAndFeelKey = lookAndFeelCacheKey(lookAndFeelName);
+    KConfig startupState(QStringLiteral("plasmaloginstartuprc"), KConfig::SimpleConfig, QStandardPaths::GenericStateLocation);
+    KConfigGroup lookAndFeelState(&startupState, QStringLiteral("LookAndFeel"));
+
+    // The KCM applies the synced look and feel once when the settings are saved,
+    // use that result as long as it was made for the installed package version
+    const QString precomputedDir = QStringLiteral(PLASMALOGIN_LOOKANDFEEL_CACHE_DIR);
+    const KConfig precomputed(precomputedDir + QLatin1String("/stamp"), KConfig::SimpleConfig);
+    const KConfigGroup precomputedState(&precomputed, QStringLiteral("LookAndFeel"));
+    const bool usePrecomputed =
+        lookAndFeelContents == KLookAndFeelManager::AllSettings && precomputedState.readEntry("Version", QString()) == lookAndFeelKey;
+    if (usePrecomputed) {
+        qputenv("XDG_CONFIG_DIRS", QByteArray(QFile::encodeName(precomputedDir + QLatin1String("/kdedefaults")) + ':' + currentConfigDirs));
+    } else if (activeLnf.readLine() != lookAndFeelName.toUtf8() || lookAndFeelState.readEntry("Applied", QString()) != lookAndFeelKey) {
         KPackage::Package package = KPackage::PackageLoader::self()->loadPackage(QStringLiteral("Plasma/LookAndFeel"), lookAndFeelName);
         KLookAndFeelManager lnfManager;
         lnfManager.setMode(KLookAndFeelManager::Mode::Defaults);
         lnfManager.save(package, lookAndFeelContents);
+        lookAndFeelState.writeEntry("Applied", lookAndFeelKey);
+        lookAndFeelState.sync();
     }
     // check if colors changed, if so apply them and discard plasma cache
     {
-        KLookAndFeelManager lnfManager;
-        lnfManager.setMode(KLookAndFeelManager::Mode::Apply);
         KConfig globals(QStringLiteral("kdeglobals")); // Reload the config
         KConfigGroup generalGroup(&globals, QStringLiteral("General"));
         const QString colorScheme = generalGroup.readEntry("ColorScheme", QStringLiteral("BreezeLight"));
-        QString path = lnfManager.colorSchemeFile(colorScheme);
-
-        if (!path.isEmpty()) {
-            QFile f(path);
-            QCryptographicHash hash(QCryptographicHash::Sha1);
-            if (f.open(QFile::ReadOnly) && hash.addData(&f)) {
-                const QString fileHash = QString::fromUtf8(hash.result().toHex());
-                if (fileHash != generalGroup.readEntry("ColorSchemeHash", QString())) {
-                    lnfManager.setColors(colorScheme, path);
-                    generalGroup.writeEntry("ColorSchemeHash", fileHash);
-                    generalGroup.sync();
+        const QString colorSchemeHash = generalGroup.readEntry("ColorSchemeHash", QString());
+        // the KCM already applied these colors to the precomputed defaults
+        const bool precomputedColors = usePrecomputed && !colorSchemeHash.isEmpty() && precomputedState.readEntry("ColorScheme", QString()) == colorScheme
+            && precomputedState.readEntry("ColorSchemeHash", QString()) == colorSchemeHash;
+        if (!precomputedColors) {
+            KLookAndFeelManager lnfManager;
+            lnfManager.setMode(KLookAndFeelManager::Mode::Apply);
+            QString path = lnfManager.colorSchemeFile(colorScheme);
+
+            // only hash the scheme again if the file was touched since the last check,
+            // or kdeglobals no longer has the hash of the applied colors (e.g. a settings
+            // sync replaced it)
+            const QFileInfo schemeInfo(path);
+            const QString schemeStamp = path + QLatin1Char(':') + QString::number(schemeInfo.lastModified().toMSecsSinceEpoch()) + QLatin1Char(':')
+                + QString::number(schemeInfo.size()) + QLatin1Char(':');
+            if (!path.isEmpty() && lookAndFeelState.readEntry("ColorSchemeStamp", QString()) != schemeStamp + colorSchemeHash) {
+                QFile f(path);
+                QCryptographicHash hash(QCryptographicHash::Sha1);
+                if (f.open(QFile::ReadOnly) && hash.addData(&f)) {
+                    const QString fileHash = QString::fromUtf8(hash.result().toHex());
+                    if (fileHash != colorSchemeHash) {
+                        lnfManager.setColors(colorScheme, path);
+                        generalGroup.writeEntry("ColorSchemeHash", fileHash);
+                        generalGroup.sync();
+                    }
+                    lookAndFeelState.writeEntry("ColorSchemeStamp", schemeStamp + fileHash);
+                    lookAndFeelState.sync();
                 }
             }
         }
@@ -369,9 +422,8 @@ void cleanupPlasmaEnvironment(const std::optional<QProcessEnvironment> &oldSyste
 // Drop session-specific variables from the systemd environment.
 // Those can be leftovers from previous sessions, which can interfere with the session
 // we want to start now, e.g. $DISPLAY might break kwin_wayland.
-static void dropSessionVarsFromSystemdEnvironment()
+static void dropSessionVarsFromSystemdEnvironment(const std::optional<QProcessEnvironment> &environment)
 {
-    const auto environment = getSystemdEnvironment();
     if (!environment) {
         return;
     }
@@ -390,17 +442,16 @@ static void dropSessionVarsFromSystemdEnvironment()
                                               QStringLiteral("org.freedesktop.systemd1.Manager"),
                                               QStringLiteral("UnsetEnvironment"));
     msg << varsToDrop;
-    auto reply = QDBusConnection::sessionBus().call(msg);
-    if (reply.type() == QDBusMessage::ErrorMessage) {
-        // qCWarning(PLASMA_STARTUP) << "Failed to unset systemd environment variables:" << reply.errorName() << reply.errorMessage();
-    }
+    // No need to wait for the reply: messages to systemd are handled in order, so this is
+    // processed before the SetEnvironment call of the following KUpdateLaunchEnvironmentJob.
+    QDBusConnection::sessionBus().send(msg);
 }
 
 // kwin_wayland can possibly also start dbus-activated services which need env variables.
 // In that case, the update in startplasma might be too late.
-bool syncDBusEnvironment()
+KUpdateLaunchEnvironmentJob *syncDBusEnvironment(const std::optional<QProcessEnvironment> &systemdEnvironment)
 {
-    dropSessionVarsFromSystemdEnvironment();
+    dropSessionVarsFromSystemdEnvironment(systemdEnvironment);
 
     // Shell and confinement variables are filtered out of things we explicitly load, but they
     // still might have been inherited from the parent process
@@ -413,11 +464,7 @@ bool syncDBusEnvironment()
     }
 
     // At this point all environment variables are set, let's send it to the DBus session server to update the activation environment
-    auto job = new KUpdateLaunchEnvironmentJob(environment);
-    QEventLoop e;
-    QObject::connect(job, &KUpdateLaunchEnvironmentJob::finished, &e, &QEventLoop::quit);
-    e.exec();
-    return true;
+    return new KUpdateLaunchEnvironmentJob(environment);
 }
 
 // If something went on an endless restart crash loop it will get blacklisted, as this is a clean login we will want to reset those counters
@@ -441,15 +488,25 @@ int main(int argc, char **argv)
     // Let clients try to reconnect to kwin after a restart
     qputenv("QT_WAYLAND_RECONNECT", "1");
 
+    // The D-Bus queries don't depend on each other or on the local set up, so send them
+    // all right away and only collect the replies once the disk bound work is done.
+    const QString locale1Service = QStringLiteral("org.freedesktop.locale1");
+    QDBusMessage locale1Message = QDBusMessage::createMethodCall(locale1Service,
+                                                                 QStringLiteral("/org/freedesktop/locale1"),
+                                                                 QStringLiteral("org.freedesktop.DBus.Properties"),
+                                                                 QStringLiteral("GetAll"));
+    locale1Message << locale1Service;
+    QDBusPendingCall locale1Call = QDBusConnection::systemBus().asyncCall(locale1Message);
+    QDBusPendingCall systemdEnvironmentCall = QDBusConnection::sessionBus().asyncCall(systemdEnvironmentMessage());
+
+    setupPlasmaEnvironment();
+    runStartupConfig();
+
     // Query whether org.freedesktop.locale1 is available. If it is, try to
     // set XKB_DEFAULT_{MODEL,LAYOUT,VARIANT,OPTIONS} accordingly.
+    locale1Call.waitForFinished();
     {
-        const QString locale1Service = QStringLiteral("org.freedesktop.locale1");
-        const QString locale1Path = QStringLiteral("/org/freedesktop/locale1");
-        QDBusMessage message =
-            QDBusMessage::createMethodCall(locale1Service, locale1Path, QStringLiteral("org.freedesktop.DBus.Properties"), QStringLiteral("GetAll"));
-        message << locale1Service;
-        QDBusMessage resultMessage = QDBusConnection::systemBus().call(message);
+        const QDBusMessage resultMessage = locale1Call.reply();
         if (resultMessage.type() == QDBusMessage::ReplyMessage) {
             QVariantMap result;
             QDBusArgument dbusArgument = resultMessage.arguments().at(0).value<QDBusArgument>();
@@ -473,26 +530,25 @@ int main(int argc, char **argv)
         }
     }
 
-    setupPlasmaEnvironment();
-    runStartupConfig();
-
-    auto oldSystemdEnvironment = getSystemdEnvironment();
-    if (!syncDBusEnvironment()) {
-        out << "Could not sync environment to dbus.\n";
-        return 1;
-    };
+    systemdEnvironmentCall.waitForFinished();
+    auto job = syncDBusEnvironment(systemdEnvironmentFromReply(systemdEnvironmentCall.reply()));
 
-    {
+    // Start the target as soon as the environment it inherits is in place
+    QObject::connect(job, &KUpdateLaunchEnvironmentJob::finished, &app, [] {
         auto msg = QDBusMessage::createMethodCall(QStringLiteral("org.freedesktop.systemd1"),
                                                   QStringLiteral("/org/freedesktop/systemd1"),
                                                   QStringLiteral("org.freedesktop.systemd1.Manager"),
                                                   QStringLiteral("StartUnit"));
         msg << QStringLiteral("plasma-login-wayland.target") << QStringLiteral("fail");
-        QDBusReply<QDBusObjectPath> reply = QDBusConnection::sessionBus().call(msg);
-        if (!reply.isValid()) {
-            qWarning() << "Could not start systemd managed Plasma session:" << reply.error().name() << reply.error().message();
-        }
-    }
+        auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(msg));
+        QObject::connect(watcher, &QDBusPendingCallWatcher::finished, watcher, [](QDBusPendingCallWatcher *call) {
+            call->deleteLater();
+            QDBusPendingReply<QDBusObjectPath> reply = *call;
+            if (reply.isError()) {
+                qWarning() << "Could not start systemd managed Plasma session:" << reply.error().name() << reply.error().message();
+            }
+        });
+    });
 
     // stopped by the sigterm handler
     app.exec();
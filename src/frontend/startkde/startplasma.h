@@ -11,10 +11,13 @@
 // #include <ksplashinterface.h>
 #include <optional>
 
+#include <QDBusMessage>
 #include <QProcessEnvironment>
 #include <QString>
 #include <QTextStream>
 
+class KUpdateLaunchEnvironmentJob;
+
 extern QTextStream out;
 
 void sigtermHandler(int signalNumber);
@@ -24,11 +27,12 @@ int runSync(const QString &program, const QStringList &args, const QStringList &
 void createConfigDirectory();
 void runStartupConfig();
 std::optional<QProcessEnvironment> getSystemdEnvironment();
+std::optional<QProcessEnvironment> systemdEnvironmentFromReply(const QDBusMessage &reply);
 void importSystemdEnvrionment();
 void runEnvironmentScripts();
 void setupPlasmaEnvironment();
 void cleanupPlasmaEnvironment(const std::optional<QProcessEnvironment> &oldSystemdEnvironment);
-bool syncDBusEnvironment();
+KUpdateLaunchEnvironmentJob *syncDBusEnvironment(const std::optional<QProcessEnvironment> &systemdEnvironment);
 void setupFontDpi();
 QProcess *setupKSplash();
 
@@ -14,9 +14,15 @@ Item {
 
     property alias source: wallpaperBlur.source
     property real factor: 0
+    // Set for wallpapers that keep changing, their blur has to follow every frame.
+    // Otherwise the blurred and graded wallpaper is rendered once and faded in.
+    property bool live: false
+    // Reduced-cost profile: the blur is rendered once and shown without fading
+    property bool lightweight: false
     readonly property bool lightColorScheme: Math.max(Kirigami.Theme.backgroundColor.r, Kirigami.Theme.backgroundColor.g, Kirigami.Theme.backgroundColor.b) > 0.5
 
     Behavior on factor {
+        enabled: !wallpaperFader.lightweight
         NumberAnimation {
             target: wallpaperFader
             property: "factor"
@@ -25,10 +31,47 @@ Item {
         }
     }
 
+    function updateCache() {
+        if (!wallpaperFader.live) {
+            blurSource.scheduleUpdate();
+            gradedCache.scheduleUpdate();
+        }
+    }
+
+    // Set while the blur is faded out. The cache isn't rendered then and is
+    // refreshed when the blur is brought back, the wallpaper may have changed meanwhile.
+    property bool fadedOut: true
+
+    onFactorChanged: {
+        if (factor <= 0) {
+            fadedOut = true;
+        } else if (fadedOut) {
+            fadedOut = false;
+            updateCache();
+        }
+    }
+    onSourceChanged: updateCache()
+    onWidthChanged: updateCache()
+    onHeightChanged: updateCache()
+    onLightColorSchemeChanged: updateCache()
+
+    // a new image of the same wallpaper plugin, once it has been loaded
+    Connections {
+        target: wallpaperFader.source
+        ignoreUnknownSignals: true
+        function onIsLoadingChanged() {
+            if (!wallpaperFader.source.loading) {
+                wallpaperFader.updateCache();
+            }
+        }
+    }
+
+    // only rendered through blurSource, the wallpaper itself stays visible underneath
     FastBlur {
         id: wallpaperBlur
         anchors.fill: parent
-        radius: 50 * wallpaperFader.factor
+        radius: 50
+        visible: false
     }
 
     ShaderEffect {
@@ -38,15 +81,16 @@ Item {
         supportsAtlasTextures: true
 
         property var source: ShaderEffectSource {
+            id: blurSource
             sourceItem: wallpaperBlur
-            live: true
+            live: wallpaperFader.live
             hideSource: true
             textureMirroring: ShaderEffectSource.NoMirroring
         }
 
-        readonly property real contrast: 0.8 * wallpaperFader.factor + (1 - wallpaperFader.factor)
-        readonly property real saturation: 1.5 * wallpaperFader.factor + (1 - wallpaperFader.factor)
-        readonly property real intensity: (wallpaperFader.lightColorScheme ? 1.6 : 0.7) * wallpaperFader.factor + (1 - wallpaperFader.factor)
+        readonly property real contrast: 0.8
+        readonly property real saturation: 1.5
+        readonly property real intensity: wallpaperFader.lightColorScheme ? 1.6 : 0.7
 
         readonly property real transl: (1.0 - contrast) / 2.0;
         readonly property real rval: (1.0 - saturation) * 0.2126;
@@ -70,4 +114,16 @@ Item {
 
         fragmentShader: "qrc:/qt/qml/org/kde/plasma/login/wallpaper/shaders/WallpaperFader.frag.qsb"
     }
+
+    // The fully blurred and graded wallpaper, faded in over the unblurred one.
+    // Nothing is rendered while it's invisible.
+    ShaderEffectSource {
+        id: gradedCache
+        anchors.fill: parent
+        sourceItem: wallpaperShader
+        live: wallpaperFader.live
+        hideSource: true
+        opacity: wallpaperFader.factor
+        visible: opacity > 0
+    }
 }
@@ -4,20 +4,42 @@
  *  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
  */
 
+#include <QQmlExtensionPlugin>
 #include <QQuickWindow>
 #include <QSurfaceFormat>
 
+#include "plasmaloginsettings.h"
 #include "wallpaperapp.h"
 
+#include <signal.h>
+
+Q_IMPORT_QML_PLUGIN(org_kde_plasma_login_wallpaperPlugin)
+
+// systemd stops the wallpaper with SIGTERM, quit normally so the windows save
+// their pipeline cache on the way out
+static void sigtermHandler(int signalNumber)
+{
+    Q_UNUSED(signalNumber)
+    if (QCoreApplication::instance()) {
+        QCoreApplication::instance()->quit();
+    }
+}
+
 int main(int argc, char **argv)
 {
     QCoreApplication::setApplicationName(QStringLiteral("plasma-login-wallpaper"));
 
+    // the greeter shows the wallpaper itself
+    if (PlasmaLoginSettings::getInstance().singleProcess()) {
+        return 0;
+    }
+
     auto format = QSurfaceFormat::defaultFormat();
     format.setOption(QSurfaceFormat::ResetNotification);
     QSurfaceFormat::setDefaultFormat(format);
 
     WallpaperApp app(argc, argv);
+    signal(SIGTERM, sigtermHandler);
 
     return app.exec();
 }
@@ -21,14 +21,37 @@ Item {
 
     property alias wallpaperContainer: wallpaperPlaceholder
 
+    readonly property bool paused: Window.window?.paused ?? false
+
     Item {
         id: wallpaperPlaceholder
         anchors.fill: parent
+        // the frozen copy below is shown instead
+        visible: !main.paused
+    }
+
+    // While the greeter is idle or the output is off the last frame is kept
+    // and the wallpaper, animated or not, is not rendered anymore
+    ShaderEffectSource {
+        id: frozenWallpaper
+        anchors.fill: parent
+        sourceItem: wallpaperPlaceholder
+        live: false
+        hideSource: visible
+        visible: main.paused
+        onVisibleChanged: {
+            if (visible) {
+                scheduleUpdate();
+            }
+        }
     }
 
     PlasmaLoginWallpaper.WallpaperFader {
         anchors.fill: parent
         factor: Window.window?.blur ? 1 : 0
+        lightweight: Window.window?.lightweight ?? false
         source: wallpaperPlaceholder.children[0]
+        // a still image or colour only needs to be blurred once
+        live: !main.paused && !lightweight && !["org.kde.image", "org.kde.color"].includes(wallpaperPlaceholder.children[0]?.pluginName ?? "")
     }
 }
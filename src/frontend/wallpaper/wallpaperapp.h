@@ -10,12 +10,9 @@
 
 #include <QGuiApplication>
 #include <QObject>
-#include <QQmlEngine>
 #include <QString>
 
-#include <KPackage/PackageStructure>
-
-class WallpaperWindow;
+class WallpaperManager;
 
 class WallpaperApp : public QGuiApplication
 {
@@ -28,12 +25,12 @@ public:
     // DBus interface
 public Q_SLOTS:
     Q_SCRIPTABLE void blurScreen(const QString &screenName);
+    /**
+     * Set by the greeter: "active" while it's used, "idle" once it timed
+     * out and "off" after it turned the screens off. Only "active" renders.
+     */
+    Q_SCRIPTABLE void setIdleState(const QString &state);
 
 private:
-    void createWindowForScreen(QScreen *screen);
-    void setupWallpaperPlugin(WallpaperWindow *window);
-
-    KPackage::Package m_wallpaperPackage;
-    QList<WallpaperWindow *> m_windows;
-    std::shared_ptr<QQmlEngine> m_engine;
+    WallpaperManager *m_manager = nullptr;
 };
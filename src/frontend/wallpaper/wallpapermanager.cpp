@@ -0,0 +1,228 @@
+/*
+    SPDX-FileCopyrightText: 2010 Ivan Cukic <ivan.cukic(at)kde.org>
+    SPDX-FileCopyrightText: 2013 Martin Klapetek <mklapetek(at)kde.org>
+    SPDX-FileCopyrightText: 2025 Oliver Beard <olib141@outlook.com
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QFile>
+#include <QGuiApplication>
+#include <QQmlComponent>
+#include <QQmlContext>
+#include <QQuickItem>
+#include <QScreen>
+#include <QTimer>
+
+#include <KConfigLoader>
+#include <KConfigPropertyMap>
+#include <KPackage/PackageLoader>
+#include <KScreenDpms/Dpms>
+#include <LayerShellQt/Window>
+
+#include "pipelinecache.h"
+#include "plasmaloginsettings.h"
+
+#include "wallpaperwindow.h"
+
+#include "wallpapermanager.h"
+
+WallpaperManager::WallpaperManager(std::shared_ptr<QQmlEngine> engine, QObject *parent)
+    : QObject(parent)
+    , m_engine(std::move(engine))
+{
+    m_wallpaperPackage = KPackage::PackageLoader::self()->loadPackage(QStringLiteral("Plasma/Wallpaper"));
+    m_wallpaperPackage.setPath(PlasmaLoginSettings::getInstance().wallpaperPluginId());
+
+    m_hotplugTimer = new QTimer(this);
+    m_hotplugTimer->setSingleShot(true);
+    m_hotplugTimer->setInterval(250);
+    connect(m_hotplugTimer, &QTimer::timeout, this, &WallpaperManager::syncScreens);
+
+    connect(qApp, &QGuiApplication::screenAdded, m_hotplugTimer, qOverload<>(&QTimer::start));
+    connect(qApp, &QGuiApplication::screenRemoved, this, [this](QScreen *screen) {
+        parkWindowOfScreen(screen);
+        m_hotplugTimer->start();
+    });
+    syncScreens();
+
+    m_idleTimer = new QTimer(this);
+    m_idleTimer->setSingleShot(true);
+    m_idleTimer->setInterval(5000);
+    connect(m_idleTimer, &QTimer::timeout, this, [this] {
+        m_idle = true;
+        updatePaused();
+    });
+
+    m_dpms = new KScreen::Dpms(this);
+    connect(m_dpms, &KScreen::Dpms::modeChanged, this, [this](KScreen::Dpms::Mode mode, QScreen *screen) {
+        if (mode == KScreen::Dpms::On) {
+            m_screensOff.remove(screen);
+        } else {
+            m_screensOff.insert(screen);
+        }
+        updatePaused();
+    });
+    connect(qApp, &QGuiApplication::screenRemoved, this, [this](QScreen *screen) {
+        m_screensOff.remove(screen);
+    });
+}
+
+void WallpaperManager::syncScreens()
+{
+    const QList<QScreen *> screens = qApp->screens();
+    for (QScreen *screen : screens) {
+        if (m_windows.contains(screen)) {
+            continue;
+        }
+        WallpaperWindow *window = m_parkedWindows.isEmpty() ? createWindow() : m_parkedWindows.takeLast();
+        showWindowOnScreen(window, screen);
+    }
+
+    while (m_parkedWindows.size() > s_maxParkedWindows) {
+        delete m_parkedWindows.takeFirst();
+    }
+}
+
+WallpaperWindow *WallpaperManager::createWindow()
+{
+    WallpaperWindow *window = new WallpaperWindow(m_engine.get());
+    window->QObject::setParent(this);
+    window->setColor(Qt::black);
+    PipelineCache::setup(window, QStringLiteral("wallpaper"));
+
+    if (auto layerShellWindow = LayerShellQt::Window::get(window)) {
+        layerShellWindow->setScope(QStringLiteral("plasma-login-wallpaper"));
+        layerShellWindow->setLayer(LayerShellQt::Window::LayerBackground);
+        layerShellWindow->setExclusiveZone(-1);
+        layerShellWindow->setKeyboardInteractivity(LayerShellQt::Window::KeyboardInteractivityNone);
+    }
+
+    window->setResizeMode(QQuickView::SizeRootObjectToView);
+
+    setupWallpaperPlugin(window);
+    return window;
+}
+
+void WallpaperManager::showWindowOnScreen(WallpaperWindow *window, QScreen *screen)
+{
+    m_windows.insert(screen, window);
+
+    window->setScreen(screen);
+    window->setGeometry(screen->geometry());
+    if (auto layerShellWindow = LayerShellQt::Window::get(window)) {
+        layerShellWindow->setScreen(screen);
+    }
+
+    connect(screen, &QScreen::geometryChanged, window, [window, screen](const QRect &geometry) {
+        if (window->screen() == screen) {
+            window->setGeometry(geometry);
+        }
+    });
+
+    window->setPaused(m_idle || m_screensOff.contains(screen));
+    window->show();
+}
+
+void WallpaperManager::parkWindowOfScreen(QScreen *screen)
+{
+    WallpaperWindow *window = m_windows.take(screen);
+    if (!window) {
+        return;
+    }
+
+    window->hide();
+    window->setBlur(false);
+    m_parkedWindows.append(window);
+}
+
+void WallpaperManager::setupWallpaperPlugin(WallpaperWindow *window)
+{
+    if (!m_wallpaperPackage.isValid()) {
+        qWarning() << "Error loading the wallpaper, not a valid package";
+        return;
+    }
+
+    const QString xmlPath = m_wallpaperPackage.filePath(QByteArrayLiteral("config"), QStringLiteral("main.xml"));
+
+    const KConfigGroup cfg = PlasmaLoginSettings::getInstance()
+                                 .sharedConfig()
+                                 ->group(QStringLiteral("Greeter"))
+                                 .group(QStringLiteral("Wallpaper"))
+                                 .group(PlasmaLoginSettings::getInstance().wallpaperPluginId());
+
+    KConfigLoader *configLoader;
+    if (xmlPath.isEmpty()) {
+        configLoader = new KConfigLoader(cfg, nullptr, this);
+    } else {
+        QFile file(xmlPath);
+        configLoader = new KConfigLoader(cfg, &file, this);
+    }
+
+    KConfigPropertyMap *config = new KConfigPropertyMap(configLoader, this);
+    // potd (picture of the day) is using a kded to monitor changes and
+    // cache data for the lockscreen. Let's notify it.
+    config->setNotify(true);
+
+    const QUrl sourceUrl = QUrl::fromLocalFile(m_wallpaperPackage.filePath("mainscript"));
+
+    auto *component = new QQmlComponent(window->engine(), sourceUrl, window);
+    if (component->isError()) {
+        qWarning() << "Failed to load wallpaper component:" << component->errors();
+        return;
+    }
+
+    window->setSource(QUrl(QStringLiteral("qrc:/qt/qml/org/kde/plasma/login/wallpaper/main.qml")));
+
+    const QVariantMap properties = {{QStringLiteral("configuration"), QVariant::fromValue(config)},
+                                    {QStringLiteral("pluginName"), PlasmaLoginSettings::getInstance().wallpaperPluginId()}};
+    QObject *wallpaperObject = component->createWithInitialProperties(properties, window->rootContext());
+    auto wallpaperItem = qobject_cast<QQuickItem *>(wallpaperObject);
+    if (!wallpaperItem) {
+        qWarning() << "Failed to create wallpaper root object:" << component->errors();
+        return;
+    }
+    auto wallpaperContainer = window->rootObject()->property("wallpaperContainer").value<QQuickItem *>();
+
+    wallpaperItem->setParentItem(wallpaperContainer);
+    wallpaperItem->setWidth(wallpaperContainer->width());
+    wallpaperItem->setHeight(wallpaperContainer->height());
+    connect(wallpaperContainer, &QQuickItem::widthChanged, wallpaperItem, [wallpaperContainer, wallpaperItem]() {
+        wallpaperItem->setWidth(wallpaperContainer->width());
+    });
+    connect(wallpaperContainer, &QQuickItem::heightChanged, wallpaperItem, [wallpaperContainer, wallpaperItem]() {
+        wallpaperItem->setHeight(wallpaperContainer->height());
+    });
+}
+
+void WallpaperManager::blurScreen(const QString &screenName)
+{
+    for (auto it = m_windows.cbegin(); it != m_windows.cend(); ++it) {
+        it.value()->setBlur(it.key()->name() == screenName);
+    }
+}
+
+void WallpaperManager::setIdleState(const QString &state)
+{
+    if (state != QLatin1String("active")) {
+        if (!m_idle && !m_idleTimer->isActive()) {
+            m_idleTimer->start();
+        }
+        return;
+    }
+
+    m_idleTimer->stop();
+    if (m_idle) {
+        m_idle = false;
+        updatePaused();
+    }
+}
+
+void WallpaperManager::updatePaused()
+{
+    for (auto it = m_windows.cbegin(); it != m_windows.cend(); ++it) {
+        it.value()->setPaused(m_idle || m_screensOff.contains(it.key()));
+    }
+}
+
+#include "moc_wallpapermanager.cpp"
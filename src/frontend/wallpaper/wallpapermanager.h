@@ -0,0 +1,75 @@
+/*
+    SPDX-FileCopyrightText: 2010 Ivan Cukic <ivan.cukic(at)kde.org>
+    SPDX-FileCopyrightText: 2013 Martin Klapetek <mklapetek(at)kde.org>
+    SPDX-FileCopyrightText: 2025 Oliver Beard <olib141@outlook.com
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QQmlEngine>
+#include <QSet>
+#include <QString>
+
+#include <KPackage/PackageStructure>
+
+#include <memory>
+
+namespace KScreen
+{
+class Dpms;
+}
+class QScreen;
+class QTimer;
+class WallpaperWindow;
+
+/**
+ * The wallpaper windows, one per screen on the background layer.
+ *
+ * Owned by the plasma-login-wallpaper process, or by the greeter when it
+ * runs the wallpaper itself (Greeter/SingleProcess) and shares its engine.
+ */
+class WallpaperManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WallpaperManager(std::shared_ptr<QQmlEngine> engine, QObject *parent = nullptr);
+
+    void blurScreen(const QString &screenName);
+    /**
+     * Set by the greeter: "active" while it's used, "idle" once it timed
+     * out and "off" after it turned the screens off. Only "active" renders.
+     */
+    void setIdleState(const QString &state);
+
+private:
+    WallpaperWindow *createWindow();
+    void showWindowOnScreen(WallpaperWindow *window, QScreen *screen);
+    void parkWindowOfScreen(QScreen *screen);
+    void syncScreens();
+    void setupWallpaperPlugin(WallpaperWindow *window);
+    void updatePaused();
+
+    KPackage::Package m_wallpaperPackage;
+    std::shared_ptr<QQmlEngine> m_engine;
+
+    // Screens come and go in bursts when docking, so hotplug is handled once things settle.
+    // Windows of removed screens are kept around, hidden, to be moved to the next added
+    // screen instead of loading the wallpaper again.
+    QTimer *m_hotplugTimer = nullptr;
+    QHash<QScreen *, WallpaperWindow *> m_windows;
+    QList<WallpaperWindow *> m_parkedWindows;
+    static constexpr int s_maxParkedWindows = 2;
+
+    bool m_idle = false;
+    // going idle is delayed, so a just started wallpaper gets to load before its frame is kept
+    QTimer *m_idleTimer = nullptr;
+    // outputs that are powered off, whatever the greeter says
+    KScreen::Dpms *m_dpms = nullptr;
+    QSet<QScreen *> m_screensOff;
+};
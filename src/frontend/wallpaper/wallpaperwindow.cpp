@@ -4,6 +4,8 @@
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 
+#include "plasmaloginsettings.h"
+
 #include "wallpaperwindow.h"
 
 WallpaperWindow::WallpaperWindow(QQmlEngine *engine)
@@ -16,6 +18,11 @@ bool WallpaperWindow::blur() const
     return m_blur;
 }
 
+bool WallpaperWindow::lightweight() const
+{
+    return PlasmaLoginSettings::getInstance().lightweight();
+}
+
 void WallpaperWindow::setBlur(bool enable)
 {
     if (m_blur == enable) {
@@ -25,3 +32,18 @@ void WallpaperWindow::setBlur(bool enable)
     m_blur = enable;
     Q_EMIT blurChanged();
 }
+
+bool WallpaperWindow::paused() const
+{
+    return m_paused;
+}
+
+void WallpaperWindow::setPaused(bool paused)
+{
+    if (m_paused == paused) {
+        return;
+    }
+
+    m_paused = paused;
+    Q_EMIT pausedChanged();
+}
@@ -14,15 +14,24 @@ class WallpaperWindow : public QQuickView
 {
     Q_OBJECT
     Q_PROPERTY(bool blur READ blur NOTIFY blurChanged)
+    Q_PROPERTY(bool lightweight READ lightweight CONSTANT)
+    Q_PROPERTY(bool paused READ paused NOTIFY pausedChanged)
 
 public:
     WallpaperWindow(QQmlEngine *engine);
     bool blur() const;
     void setBlur(bool enable);
+    bool lightweight() const;
+
+    // While paused the last frame is shown and the wallpaper isn't rendered
+    bool paused() const;
+    void setPaused(bool paused);
 
 Q_SIGNALS:
     void blurChanged();
+    void pausedChanged();
 
 private:
     bool m_blur = false;
+    bool m_paused = false;
 };
@@ -111,6 +111,10 @@ void HelperApp::setUp()
         m_backend->setGreeter(true);
     }
 
+    if ((pos = args.indexOf(QStringLiteral("--background"))) >= 0) {
+        m_session->setBackground(true);
+    }
+
     if (server.isEmpty() || m_id <= 0) {
         qCritical() << "This application is not supposed to be executed manually";
         exit(Auth::HELPER_OTHER_ERROR);
@@ -145,19 +149,18 @@ void HelperApp::doAuth()
     }
 
     m_user = m_backend->userName();
-    QProcessEnvironment env = authenticated(m_user);
+    const Environment env = authenticated(m_user);
 
     if (!m_session->path().isEmpty()) {
-        env.insert(m_session->processEnvironment());
-        m_session->setProcessEnvironment(env);
+        m_session->setEnvironment(env);
 
         if (!m_backend->openSession()) {
-            sessionOpened(false);
+            sessionOpened(false, QString());
             exit(Auth::HELPER_SESSION_ERROR);
             return;
         }
 
-        sessionOpened(true);
+        sessionOpened(true, m_session->environment().value(QStringLiteral("XDG_SESSION_ID")));
     } else {
         exit(Auth::HELPER_SUCCESS);
     }
@@ -201,10 +204,10 @@ Request HelperApp::request(const Request &request)
     return response;
 }
 
-QProcessEnvironment HelperApp::authenticated(const QString &user)
+Environment HelperApp::authenticated(const QString &user)
 {
     Msg m = Msg::MSG_UNKNOWN;
-    QProcessEnvironment env;
+    Environment env;
     SafeDataStream str(m_socket);
     str << Msg::AUTHENTICATED << user;
     str.send();
@@ -214,17 +217,17 @@ QProcessEnvironment HelperApp::authenticated(const QString &user)
     str.receive();
     str >> m >> env;
     if (m != AUTHENTICATED) {
-        env = QProcessEnvironment();
+        env = Environment();
         qCritical() << "Received a wrong opcode instead of AUTHENTICATED:" << m;
     }
     return env;
 }
 
-void HelperApp::sessionOpened(bool success)
+void HelperApp::sessionOpened(bool success, const QString &sessionId)
 {
     Msg m = Msg::MSG_UNKNOWN;
     SafeDataStream str(m_socket);
-    str << Msg::SESSION_STATUS << success;
+    str << Msg::SESSION_STATUS << success << sessionId;
     str.send();
     str.receive();
     str >> m;
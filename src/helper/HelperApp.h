@@ -10,7 +10,6 @@
 #define Auth_H
 
 #include <QtCore/QCoreApplication>
-#include <QtCore/QProcessEnvironment>
 
 #include "AuthMessages.h"
 
@@ -34,9 +33,9 @@ public slots:
     Request request(const Request &request);
     void info(const QString &message, Auth::Info type);
     void error(const QString &message, Auth::Error type);
-    QProcessEnvironment authenticated(const QString &user);
+    Environment authenticated(const QString &user);
     void displayServerStarted(const QString &displayName);
-    void sessionOpened(bool success);
+    void sessionOpened(bool success, const QString &sessionId);
 
 private slots:
     void setUp();
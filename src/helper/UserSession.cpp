@@ -28,6 +28,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <systemd/sd-journal.h>
+
 namespace PLASMALOGIN
 {
 UserSession::UserSession(HelperApp *parent)
@@ -40,7 +42,8 @@ UserSession::UserSession(HelperApp *parent)
 bool UserSession::start()
 {
     auto helper = qobject_cast<HelperApp *>(parent());
-    QProcessEnvironment env = processEnvironment();
+    const Environment &env = m_environment;
+    setProcessEnvironment(env.toProcessEnvironment());
 
     bool isWaylandGreeter = false;
 
@@ -80,7 +83,7 @@ void UserSession::stop()
 {
     if (state() != QProcess::NotRunning) {
         terminate();
-        const bool isGreeter = processEnvironment().value(QStringLiteral("XDG_SESSION_CLASS")) == QLatin1String("greeter");
+        const bool isGreeter = m_environment.value(QStringLiteral("XDG_SESSION_CLASS")) == QLatin1String("greeter");
 
         // Wait longer for a session than a greeter
         if (!waitForFinished(isGreeter ? 5000 : 60000)) {
@@ -104,15 +107,30 @@ QString UserSession::path() const
     return m_path;
 }
 
+void UserSession::setEnvironment(const Environment &environment)
+{
+    m_environment = environment;
+}
+
+Environment UserSession::environment() const
+{
+    return m_environment;
+}
+
+void UserSession::setBackground(bool background)
+{
+    m_background = background;
+}
+
 void UserSession::childModifier()
 {
     // Session type
-    QString sessionType = processEnvironment().value(QStringLiteral("XDG_SESSION_TYPE"));
-    QString sessionClass = processEnvironment().value(QStringLiteral("XDG_SESSION_CLASS"));
+    QString sessionType = m_environment.value(QStringLiteral("XDG_SESSION_TYPE"));
+    QString sessionClass = m_environment.value(QStringLiteral("XDG_SESSION_CLASS"));
     const bool x11Session = sessionType == QLatin1String("x11");
 
     // open VT and get the fd
-    int vtNumber = processEnvironment().value(QStringLiteral("XDG_VTNR")).toInt();
+    int vtNumber = m_environment.value(QStringLiteral("XDG_VTNR")).toInt();
     QString ttyString = VirtualTerminal::path(vtNumber);
     int vtFd = ::open(qPrintable(ttyString), O_RDWR | O_NOCTTY);
 
@@ -144,7 +162,7 @@ void UserSession::childModifier()
         }
     }
 
-    if (vtNumber > 0) {
+    if (vtNumber > 0 && !m_background) {
         VirtualTerminal::jumpToVt(vtNumber, x11Session);
     }
 
@@ -248,7 +266,20 @@ void UserSession::childModifier()
         exit(Auth::HELPER_OTHER_ERROR);
     }
 
-    if (sessionClass != QLatin1String("greeter")) {
+    if (PlasmaLogin::config()->sessionLogJournal()) {
+        // Connect stdout and stderr straight to journald. We do this after setuid so that
+        // journald attributes the stream to the user, together with the logind session
+        // (and with it the seat) of this process.
+        const char *identifier = sessionClass == QLatin1String("greeter") ? "plasmalogin-greeter" : "plasmalogin-session";
+        int fd = sd_journal_stream_fd(identifier, LOG_INFO, 0);
+        if (fd >= 0) {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            ::close(fd);
+        } else {
+            qWarning() << "Could not connect the session output to journald:" << strerror(-fd);
+        }
+    } else if (sessionClass != QLatin1String("greeter")) {
         // we cannot use setStandardError file as this code is run in the child process
         // we want to redirect after we setuid so that the log file is owned by the user
 
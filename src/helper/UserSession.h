@@ -13,6 +13,8 @@
 #include <QtCore/QObject>
 #include <QtCore/QProcess>
 
+#include "Environment.h"
+
 namespace PLASMALOGIN
 {
 class HelperApp;
@@ -33,6 +35,17 @@ public:
     void setPath(const QString &path);
     QString path() const;
 
+    /**
+     * Environment of the session, applied to the process when it is started
+     */
+    void setEnvironment(const Environment &environment);
+    Environment environment() const;
+
+    /**
+     * Don't switch to the session's VT when starting it, used for standby greeters
+     */
+    void setBackground(bool background);
+
 Q_SIGNALS:
     void finished(int exitCode);
 
@@ -43,6 +56,8 @@ private:
     void childModifier();
 
     QString m_path{};
+    Environment m_environment{};
+    bool m_background{false};
 };
 }
 
@@ -14,7 +14,6 @@
 #include "VirtualTerminal.h"
 
 #include <QtCore/QDebug>
-#include <QtCore/QProcessEnvironment>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QString>
 
@@ -249,7 +248,8 @@ bool PamBackend::openSession()
         return false;
     }
 
-    QProcessEnvironment sessionEnv = m_app->session()->processEnvironment();
+    // build the whole session environment here and hand it over once
+    Environment sessionEnv = m_app->session()->environment();
     const auto sessionType = sessionEnv.value(QStringLiteral("XDG_SESSION_TYPE"));
     const auto sessionClass = sessionEnv.value(QStringLiteral("XDG_SESSION_CLASS"));
     if (sessionEnv.contains(QStringLiteral("XDG_VTNR"))) {
@@ -276,22 +276,22 @@ bool PamBackend::openSession()
         return false;
     }
     sessionEnv.insert(m_pam->getEnv());
-    m_app->session()->setProcessEnvironment(sessionEnv);
 
-    QProcessEnvironment env = m_app->session()->processEnvironment();
     struct passwd *pw;
     pw = getpwnam(qPrintable(m_app->user()));
     if (pw) {
-        env.insert(QStringLiteral("HOME"), QString::fromLocal8Bit(pw->pw_dir));
-        env.insert(QStringLiteral("PWD"), QString::fromLocal8Bit(pw->pw_dir));
-        env.insert(QStringLiteral("SHELL"), QString::fromLocal8Bit(pw->pw_shell));
-        env.insert(QStringLiteral("USER"), QString::fromLocal8Bit(pw->pw_name));
-        env.insert(QStringLiteral("LOGNAME"), QString::fromLocal8Bit(pw->pw_name));
+        const QString home = QString::fromLocal8Bit(pw->pw_dir);
+        const QString name = QString::fromLocal8Bit(pw->pw_name);
+        sessionEnv.insert(QStringLiteral("HOME"), home);
+        sessionEnv.insert(QStringLiteral("PWD"), home);
+        sessionEnv.insert(QStringLiteral("SHELL"), QString::fromLocal8Bit(pw->pw_shell));
+        sessionEnv.insert(QStringLiteral("USER"), name);
+        sessionEnv.insert(QStringLiteral("LOGNAME"), name);
     }
-    if (env.value(QStringLiteral("XDG_SESSION_CLASS")) == QLatin1String("greeter")) {
-        env.insert(QStringLiteral("QT_NO_XDG_DESKTOP_PORTAL"), QStringLiteral("1"));
+    if (sessionClass == QLatin1String("greeter")) {
+        sessionEnv.insert(QStringLiteral("QT_NO_XDG_DESKTOP_PORTAL"), QStringLiteral("1"));
     }
-    m_app->session()->setProcessEnvironment(env);
+    m_app->session()->setEnvironment(sessionEnv);
     return m_app->session()->start();
 }
 
@@ -12,7 +12,7 @@
 
 namespace PLASMALOGIN
 {
-bool PamHandle::putEnv(const QProcessEnvironment &env)
+bool PamHandle::putEnv(const Environment &env)
 {
     const auto envs = env.toStringList();
     for (const QString &s : envs) {
@@ -25,9 +25,9 @@ bool PamHandle::putEnv(const QProcessEnvironment &env)
     return true;
 }
 
-QProcessEnvironment PamHandle::getEnv()
+Environment PamHandle::getEnv()
 {
-    QProcessEnvironment env;
+    Environment env;
     // get pam environment
     char **envlist = pam_getenvlist(m_handle);
     if (envlist == NULL) {
@@ -9,8 +9,10 @@
 #ifndef PAMHANDLE_H
 #define PAMHANDLE_H
 
+#include "Environment.h"
+
 #include <QtCore/QObject>
-#include <QtCore/QProcessEnvironment>
+
 #include <security/pam_appl.h>
 
 namespace PLASMALOGIN
@@ -125,7 +127,7 @@ public:
      *
      * \return Complete process environment
      */
-    QProcessEnvironment getEnv();
+    Environment getEnv();
 
     /**
      * pam_putenv - set or change PAM environment
@@ -134,7 +136,7 @@ public:
      *
      * \return true on success
      */
-    bool putEnv(const QProcessEnvironment &env);
+    bool putEnv(const Environment &env);
 
     /**
      * pam_end - termination of PAM transaction